@@ -1,6 +1,7 @@
 ﻿#include "FomodPlusInstaller.h"
 
 #include <QEventLoop>
+#include <QFile>
 #include <QTreeWidget>
 #include <igamefeatures.h>
 #include <iinstallationmanager.h>
@@ -39,6 +40,8 @@ bool FomodPlusInstaller::init(IOrganizer* organizer)
 
     // REMEMBER: This mFomodDB persists beyond the scope of an individual install. Do not do anything nasty to it.
     mFomodDb = std::make_unique<FomodDB>(mOrganizer->basePath().toStdString());
+    mModuleConfigCache = std::make_unique<ModuleConfigCache>(
+        std::filesystem::path(mOrganizer->basePath().toStdWString()) / MODULE_CONFIG_CACHE_DIR);
     setupUiInjection();
     return true;
 }
@@ -329,8 +332,7 @@ IPluginInstaller::EInstallResult FomodPlusInstaller::install(
 
         try {
             dbEntry->applySelections(*mFomodJson);
-            mFomodDb->addEntry(dbEntry);
-            mFomodDb->saveToFile();
+            mFomodDb->commitEntry(dbEntry);
         } catch ([[maybe_unused]] Exception& e) {
             logMessage(ERR, "Failed to add FomodDB entries.");
             logMessage(ERR, e.what());
@@ -382,13 +384,28 @@ ParsedFilesTuple FomodPlusInstaller::parseFomodFiles(const std::shared_ptr<IFile
     appendPluginFiles(toExtract, tree); // For patch finder data collection
     const auto paths = manager()->extractFiles(toExtract);
 
-    auto moduleConfiguration = std::make_unique<ModuleConfiguration>();
+    QFile moduleConfigFile(paths.at(0));
+    if (!moduleConfigFile.open(QIODevice::ReadOnly)) {
+        logMessage(ERR, "FomodPlusInstaller::install - could not read moduleConfig.xml");
+        return emptyResult;
+    }
+    const QByteArray moduleConfigXml = moduleConfigFile.readAll();
+    moduleConfigFile.close();
+    const std::span<const char> moduleConfigBytes(moduleConfigXml.constData(), moduleConfigXml.size());
+
+    // Reinstalls and FOMODs the Patch Finder has already scanned come back from the cache instead of the XML parser.
+    std::unique_ptr<ModuleConfiguration> moduleConfiguration;
     try {
-        moduleConfiguration->deserialize(paths.at(0));
+        moduleConfiguration = mModuleConfigCache->parse(moduleConfigBytes);
     } catch (XmlParseException& e) {
         logMessage(ERR, std::format("FomodPlusInstaller::install - error parsing moduleConfig.xml: {}", e.what()));
         return emptyResult;
     }
+    if (!moduleConfiguration) {
+        logMessage(ERR, "FomodPlusInstaller::install - error parsing moduleConfig.xml");
+        return emptyResult;
+    }
+    mModuleConfigCache->trim();
 
     auto infoFile = std::make_unique<FomodInfoFile>();
     if (infoXML) {
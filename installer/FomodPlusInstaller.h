@@ -13,6 +13,7 @@
 #include <nlohmann/json.hpp>
 
 #include <FOMODData/FomodDb.h>
+#include <FOMODData/ModuleConfigCache.h>
 #include <QDialog>
 #include <integration/FomodDataContent.h>
 
@@ -83,6 +84,7 @@ class FomodPlusInstaller final : public IPluginInstallerSimple {
     bool mInstallerUsed { false };
     std::shared_ptr<FomodDataContent> mFomodContent { nullptr };
     std::unique_ptr<FomodDB> mFomodDb;
+    std::unique_ptr<ModuleConfigCache> mModuleConfigCache;
 
     /**
      * @brief Retrieve the tree entry corresponding to the fomod directory.
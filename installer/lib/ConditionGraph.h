@@ -0,0 +1,251 @@
+#pragma once
+
+#include "FlagMap.h"
+#include "stringutil.h"
+#include "xml/ModuleConfiguration.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+The conditions of one installer session (step visibility, plugin type descriptors, conditional installs), compiled into
+a DAG the first time each is tested.
+
+    Constant    A file or game dependency. MO2's answer doesn't change while the installer is open, so it is asked once,
+                when the condition is compiled.
+    Flag        One flag dependency: key == value (or key unset, for an empty value).
+    All / Any   A CompositeDependency. Identical leaves and subtrees are shared, so a flag test that fifty patterns use
+                is one node.
+    PluginType  A plugin's type descriptor: the type of the first pattern that holds, else its fallback.
+
+Every node remembers its last result and knows the flag keys it (transitively) reads. Before evaluating, the graph
+compares each key's FlagMap::getKeyVersion with the one it last saw and marks only that key's readers dirty, so a click
+re-evaluates the patterns and plugins that depend on the flags it changed and reuses everything else. Evaluation
+short-circuits, and children that were skipped are evaluated when first needed.
+
+Conditions are looked up by address, so they must outlive the graph. They belong to the session's ModuleConfiguration,
+which the view models keep alive.
+*/
+
+class ConditionGraph {
+  public:
+    using NodeId = uint32_t;
+
+    struct StaticTests {
+        std::function<bool(const FileDependency&)> file;
+        std::function<bool(const GameDependency&)> game;
+    };
+
+    ConditionGraph()
+    {
+        mNodes.push_back({ .kind = Kind::Constant, .dirty = false, .result = false });
+        mNodes.push_back({ .kind = Kind::Constant, .dirty = false, .result = true });
+    }
+
+    NodeId compile(const CompositeDependency& dependency, const StaticTests& tests)
+    {
+        if (const auto it = mCompiledConditions.find(&dependency); it != mCompiledConditions.end()) {
+            return it->second;
+        }
+        std::vector<NodeId> children;
+        children.reserve(dependency.fileDependencies.size() + dependency.flagDependencies.size()
+            + dependency.gameDependencies.size() + dependency.nestedDependencies.size());
+        for (const auto& fileDependency : dependency.fileDependencies) {
+            children.push_back(constant(tests.file(fileDependency)));
+        }
+        for (const auto& flagDependency : dependency.flagDependencies) {
+            children.push_back(flag(flagDependency));
+        }
+        for (const auto& gameDependency : dependency.gameDependencies) {
+            children.push_back(constant(tests.game(gameDependency)));
+        }
+        for (const auto& nestedDependency : dependency.nestedDependencies) {
+            children.push_back(compile(nestedDependency, tests));
+        }
+
+        const auto kind = dependency.operatorType == OperatorTypeEnum::AND ? Kind::All : Kind::Any;
+        std::string signature(1, kind == Kind::All ? '&' : '|');
+        for (const auto child : children) {
+            signature.append(reinterpret_cast<const char*>(&child), sizeof(child));
+        }
+        const auto id                    = intern(signature, { .kind = kind, .children = std::move(children) });
+        mCompiledConditions[&dependency] = id;
+        return id;
+    }
+
+    NodeId compile(const Plugin& plugin, const StaticTests& tests)
+    {
+        if (const auto it = mCompiledPlugins.find(&plugin); it != mCompiledPlugins.end()) {
+            return it->second;
+        }
+        Node node { .kind = Kind::PluginType, .fallback = fallbackType(plugin.typeDescriptor) };
+        for (const auto& pattern : plugin.typeDescriptor.dependencyType.patterns.patterns) {
+            node.children.push_back(compile(pattern.dependencies, tests));
+            node.patternTypes.push_back(pattern.type);
+        }
+        const auto id             = add(std::move(node));
+        mCompiledPlugins[&plugin] = id;
+        return id;
+    }
+
+    bool test(const NodeId id, const FlagMap& flags)
+    {
+        sync(flags);
+        return evaluate(id) != 0;
+    }
+
+    PluginTypeEnum pluginType(const NodeId id, const FlagMap& flags)
+    {
+        sync(flags);
+        return static_cast<PluginTypeEnum>(evaluate(id));
+    }
+
+    [[nodiscard]] size_t size() const { return mNodes.size(); }
+
+  private:
+    enum class Kind : uint8_t { Constant, Flag, All, Any, PluginType };
+
+    struct Node {
+        Kind kind;
+        bool dirty     = true;
+        uint8_t result = 0; // A bool, or a PluginTypeEnum for PluginType nodes
+        uint32_t key   = 0; // Flag: index into mKeys
+        std::string value; // Flag: the value it tests for
+        std::vector<NodeId> children; // All/Any: operands. PluginType: the patterns' conditions
+        std::vector<PluginTypeEnum> patternTypes;
+        PluginTypeEnum fallback = PluginTypeEnum::Optional;
+        std::vector<uint32_t> keys; // Every flag key this node reads, sorted
+    };
+
+    struct Key {
+        std::string name; // Lower case, as FlagMap stores them
+        std::optional<uint64_t> seenVersion;
+        std::vector<NodeId> readers;
+    };
+
+    std::vector<Node> mNodes;
+    std::vector<Key> mKeys;
+    std::unordered_map<std::string, uint32_t> mKeyIds;
+    std::unordered_map<std::string, NodeId> mInterned;
+    std::unordered_map<const CompositeDependency*, NodeId> mCompiledConditions;
+    std::unordered_map<const Plugin*, NodeId> mCompiledPlugins;
+    const FlagMap* mFlags { nullptr };
+    std::optional<uint64_t> mSeenRevision;
+
+    static NodeId constant(const bool value) { return value ? 1 : 0; }
+
+    static PluginTypeEnum fallbackType(const TypeDescriptor& typeDescriptor)
+    {
+        // Sometimes authors do this.
+        if (typeDescriptor.type != PluginTypeEnum::Optional) {
+            return typeDescriptor.type;
+        }
+        return typeDescriptor.dependencyType.defaultType.value_or(PluginTypeEnum::Optional);
+    }
+
+    NodeId flag(const FlagDependency& dependency)
+    {
+        const auto name     = toLower(dependency.flag);
+        auto [it, inserted] = mKeyIds.try_emplace(name, static_cast<uint32_t>(mKeys.size()));
+        if (inserted) {
+            mKeys.push_back({ .name = name });
+        }
+        return intern("=" + name + '\0' + dependency.value,
+            { .kind = Kind::Flag, .key = it->second, .value = dependency.value, .keys = { it->second } });
+    }
+
+    NodeId intern(const std::string& signature, Node node)
+    {
+        if (const auto it = mInterned.find(signature); it != mInterned.end()) {
+            return it->second;
+        }
+        const auto id        = add(std::move(node));
+        mInterned[signature] = id;
+        return id;
+    }
+
+    NodeId add(Node node)
+    {
+        for (const auto child : node.children) {
+            const auto& childKeys = mNodes[child].keys;
+            node.keys.insert(node.keys.end(), childKeys.begin(), childKeys.end());
+        }
+        std::ranges::sort(node.keys);
+        node.keys.erase(std::ranges::unique(node.keys).begin(), node.keys.end());
+
+        const auto id = static_cast<NodeId>(mNodes.size());
+        for (const auto key : node.keys) {
+            mKeys[key].readers.push_back(id);
+        }
+        mNodes.push_back(std::move(node));
+        return id;
+    }
+
+    // Mark the readers of every flag key whose value changed since the last evaluation dirty
+    void sync(const FlagMap& flags)
+    {
+        if (&flags != mFlags) {
+            mFlags        = &flags;
+            mSeenRevision = std::nullopt;
+            for (auto& key : mKeys) {
+                key.seenVersion = std::nullopt;
+            }
+        }
+        if (mSeenRevision == flags.getRevision()) {
+            return;
+        }
+        mSeenRevision = flags.getRevision();
+        for (auto& key : mKeys) {
+            const auto version = flags.getKeyVersion(key.name);
+            if (key.seenVersion == version) {
+                continue;
+            }
+            key.seenVersion = version;
+            for (const auto reader : key.readers) {
+                mNodes[reader].dirty = true;
+            }
+        }
+    }
+
+    uint8_t evaluate(const NodeId id)
+    {
+        // mNodes doesn't grow while evaluating, so this reference stays valid through the recursion
+        auto& node = mNodes[id];
+        if (!node.dirty) {
+            return node.result;
+        }
+        switch (node.kind) {
+        case Kind::Constant:
+            break;
+        case Kind::Flag: {
+            // An empty value means the flag should be unset
+            const auto& current = mFlags->getFlagValue(mKeys[node.key].name);
+            node.result         = current ? *current == node.value : node.value.empty();
+            break;
+        }
+        case Kind::All:
+            node.result = std::ranges::all_of(node.children, [this](const NodeId child) { return evaluate(child); });
+            break;
+        case Kind::Any:
+            node.result = std::ranges::any_of(node.children, [this](const NodeId child) { return evaluate(child); });
+            break;
+        case Kind::PluginType: {
+            node.result = static_cast<uint8_t>(node.fallback);
+            for (size_t i = 0; i < node.children.size(); ++i) {
+                if (evaluate(node.children[i])) {
+                    node.result = static_cast<uint8_t>(node.patternTypes[i]);
+                    break;
+                }
+            }
+            break;
+        }
+        }
+        node.dirty = false;
+        return node.result;
+    }
+};
@@ -25,7 +25,7 @@ bool ConditionTester::isStepVisible(const std::shared_ptr<FlagMap>& flags,
         return false;
     }
 
-    const auto flagDependencies = compositeDependency.flagDependencies;
+    const auto& flagDependencies = compositeDependency.flagDependencies;
     if (flagDependencies.empty()) {
         return true;
     }
@@ -60,49 +60,20 @@ bool ConditionTester::isStepVisible(const std::shared_ptr<FlagMap>& flags,
 bool ConditionTester::testCompositeDependency(
     const std::shared_ptr<FlagMap>& flags, const CompositeDependency& compositeDependency) const
 {
-    const auto fileDependencies   = compositeDependency.fileDependencies;
-    const auto flagDependencies   = compositeDependency.flagDependencies;
-    const auto gameDependencies   = compositeDependency.gameDependencies;
-    const auto nestedDependencies = compositeDependency.nestedDependencies;
-    const auto globalOperatorType = compositeDependency.operatorType;
-
-    // For the globalOperatorType
-    // Evaluate all conditions and store the results in a vector<bool>, then return based on operator.
-    // These aren't expensive to calculate so rather than do some fancy logic to short-circuit, just calculate all of
-    // 'em.
-    std::vector<bool> results;
-    for (const auto& fileDependency : fileDependencies) {
-        results.emplace_back(testFileDependency(fileDependency));
-    }
-    for (const auto& flagDependency : flagDependencies) {
-        results.emplace_back(testFlagDependency(flags, flagDependency));
-    }
-    for (const auto& gameDependency : gameDependencies) {
-        results.emplace_back(testGameDependency(gameDependency));
-    }
-    for (const auto& nestedDependency : nestedDependencies) {
-        results.emplace_back(testCompositeDependency(flags, nestedDependency));
-    }
-
-    if (globalOperatorType == OperatorTypeEnum::AND) {
-        return std::ranges::all_of(results, [](const bool result) { return result; });
-    }
-    return std::ranges::any_of(results, [](const bool result) { return result; });
+    return conditionGraph.test(conditionGraph.compile(compositeDependency, staticTests()), *flags);
 }
 
 bool ConditionTester::testFlagDependency(const std::shared_ptr<FlagMap>& flags, const FlagDependency& flagDependency)
 {
-    // Every instance of this flag being set in the map.
-    const auto flagList = flags->getFlagsByKey(flagDependency.flag);
-
-    // Find the first instance of this flag being set (in the order specified by getFlagsByKey)
-    if (flagList.empty()) {
+    // The first instance of this flag being set (in the order specified by getFlagsByKey)
+    const auto& value = flags->getFlagValue(flagDependency.flag);
+    if (!value) {
         // If the dependency value is an empty string, it means this flag should be unset.
         // So if we don't have any value for this flag, the result is true.
         return flagDependency.value.empty();
     }
 
-    return flagList.front().second == flagDependency.value;
+    return *value == flagDependency.value;
 }
 
 bool ConditionTester::testFileDependency(const FileDependency& fileDependency) const
@@ -162,21 +133,14 @@ PluginTypeEnum ConditionTester::getPluginTypeDescriptorState(
     // We only evaluate the typeDescriptor here.
 
     // We will return the 'winning' type or the default. If multiple conditions are met,
-    // ...well, I'm not sure.
-    // ReSharper disable once CppTooWideScopeInitStatement
-    const auto& dependencyType = plugin->typeDescriptor.dependencyType;
-    for (const auto& pattern : dependencyType.patterns.patterns) {
-        if (testCompositeDependency(flags, pattern.dependencies)) {
-            return pattern.type;
-        }
-    }
+    // ...well, I'm not sure. The first pattern that holds wins; see ConditionGraph.
+    return conditionGraph.pluginType(conditionGraph.compile(*plugin, staticTests()), *flags);
+}
 
-    // Sometimes authors do this.
-    if (plugin->typeDescriptor.type != PluginTypeEnum::Optional) {
-        return plugin->typeDescriptor.type;
-    }
-    if (plugin->typeDescriptor.dependencyType.defaultType.has_value()) {
-        return plugin->typeDescriptor.dependencyType.defaultType.value();
-    }
-    return PluginTypeEnum::Optional;
-}
\ No newline at end of file
+ConditionGraph::StaticTests ConditionTester::staticTests() const
+{
+    return {
+        .file = [this](const FileDependency& fileDependency) { return testFileDependency(fileDependency); },
+        .game = [this](const GameDependency& gameDependency) { return testGameDependency(gameDependency); },
+    };
+}
@@ -2,6 +2,7 @@
 
 #include <imoinfo.h>
 
+#include "ConditionGraph.h"
 #include "FlagMap.h"
 #include "Logger.h"
 #include "xml/ModuleConfiguration.h"
@@ -19,6 +20,9 @@ class ConditionTester {
     bool isStepVisible(const std::shared_ptr<FlagMap>& flags, const CompositeDependency& compositeDependency,
         int stepIndex, const std::vector<std::shared_ptr<StepViewModel>>& steps) const;
 
+    /**
+     * Evaluated through the session's compiled ConditionGraph, so compositeDependency must outlive this tester.
+     */
     bool testCompositeDependency(
         const std::shared_ptr<FlagMap>& flags, const CompositeDependency& compositeDependency) const;
 
@@ -40,4 +44,7 @@ class ConditionTester {
         const std::shared_ptr<Plugin>& plugin, const std::shared_ptr<FlagMap>& flags) const;
 
     mutable std::unordered_map<std::string, FileDependencyTypeEnum> fileDependencyCache;
+    mutable ConditionGraph conditionGraph;
+
+    [[nodiscard]] ConditionGraph::StaticTests staticTests() const;
 };
@@ -7,12 +7,12 @@
 using namespace MOBase;
 
 FileInstaller::FileInstaller(IOrganizer* organizer, QString fomodPath, const std::shared_ptr<IFileTree>& fileTree,
-    std::unique_ptr<ModuleConfiguration> fomodFile, const std::shared_ptr<FlagMap>& flagMap,
+    const std::shared_ptr<ModuleConfiguration>& fomodFile, const std::shared_ptr<FlagMap>& flagMap,
     const std::vector<std::shared_ptr<StepViewModel>>& steps)
     : mOrganizer(organizer)
     , mFomodPath(std::move(fomodPath))
     , mFileTree(fileTree)
-    , mFomodFile(std::move(fomodFile))
+    , mFomodFile(fomodFile)
     , mFlagMap(flagMap)
     , mConditionTester(organizer)
     , mSteps(steps)
@@ -175,7 +175,7 @@ std::vector<std::string> FileInstaller::collectPositiveFileNamesFromDependencyPa
 }
 
 // Generic vector appender
-void FileInstaller::addFiles(std::vector<File>& main, std::vector<File> toAdd) const
+void FileInstaller::addFiles(std::vector<File>& main, const std::vector<File>& toAdd) const
 {
     for (const auto& add : toAdd) {
         logMessage(INFO, "Adding file with source: " + add.source);
@@ -193,7 +193,7 @@ std::vector<File> FileInstaller::collectFilesToInstall() const
     std::vector<File> allFiles;
 
     // Required files from FOMOD
-    const FileList requiredInstallFiles = mFomodFile->requiredInstallFiles;
+    const FileList& requiredInstallFiles = mFomodFile->requiredInstallFiles;
     logMessage(
         DEBUG, "Adding " + std::to_string(requiredInstallFiles.files.size()) + " required install files from fomod.");
     addFiles(allFiles, requiredInstallFiles.files);
@@ -225,7 +225,7 @@ std::vector<File> FileInstaller::collectFilesToInstall() const
     }
 
     // ConditionalInstall files
-    for (const auto conditionals = mFomodFile->conditionalFileInstalls; const auto& pattern : conditionals.patterns) {
+    for (const auto& pattern : mFomodFile->conditionalFileInstalls.patterns) {
         //<folder source="CR\Dagi-Raht LL\VLrn_Custom Race - Dagi-Raht LL" destination="" priority="2" />
 
         if (mConditionTester.testCompositeDependency(mFlagMap, pattern.dependencies)) {
@@ -32,7 +32,7 @@ class StepViewModel;
 class FileInstaller {
   public:
     FileInstaller(IOrganizer* organizer, QString fomodPath, const std::shared_ptr<IFileTree>& fileTree,
-        std::unique_ptr<ModuleConfiguration> fomodFile, const std::shared_ptr<FlagMap>& flagMap,
+        const std::shared_ptr<ModuleConfiguration>& fomodFile, const std::shared_ptr<FlagMap>& flagMap,
         const std::vector<std::shared_ptr<StepViewModel>>& steps);
 
     std::shared_ptr<IFileTree> install() const;
@@ -69,14 +69,14 @@ class FileInstaller {
     std::vector<std::string> collectPositiveFileNamesFromDependencyPatterns(
         const std::vector<DependencyPattern>& patterns);
 
-    void addFiles(std::vector<File>& main, std::vector<File> toAdd) const;
+    void addFiles(std::vector<File>& main, const std::vector<File>& toAdd) const;
 
   private:
     IOrganizer* mOrganizer;
     Logger& log = Logger::getInstance();
     QString mFomodPath;
     std::shared_ptr<IFileTree> mFileTree;
-    std::unique_ptr<ModuleConfiguration> mFomodFile;
+    std::shared_ptr<ModuleConfiguration> mFomodFile;
     std::shared_ptr<FlagMap> mFlagMap;
     ConditionTester mConditionTester;
     std::vector<std::shared_ptr<StepViewModel>> mSteps; // TODO: Maybe this is nasty. Idk.
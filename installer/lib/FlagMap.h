@@ -3,6 +3,8 @@
 #include "ViewModels.h"
 #include "stringutil.h"
 
+#include <cstdint>
+#include <optional>
 #include <ranges>
 #include <string>
 #include <unordered_map>
@@ -60,6 +62,27 @@ class FlagMap {
         return result;
     }
 
+    /**
+     *
+     * @param key The flag key
+     * @return The value of the first flag set with this key, in getFlagsByKey order, or nullopt if none is set.
+     */
+    [[nodiscard]] const std::optional<std::string>& getFlagValue(const std::string& key) const
+    {
+        return getKeyState(toLower(key)).value;
+    }
+
+    /**
+     *
+     * @param key The flag key
+     * @return A counter that changes whenever getFlagValue(key) changes. Setting a key to the value it already had, as
+     * rebuilding the map after clearAll() does, leaves it alone.
+     */
+    [[nodiscard]] uint64_t getKeyVersion(const std::string& key) const { return getKeyState(toLower(key)).version; }
+
+    // Changes with every modification of the map
+    [[nodiscard]] uint64_t getRevision() const { return revision; }
+
     void setFlagsForPlugin(PluginRef plugin)
     {
         // Don't clutter the map with empty key-vals
@@ -72,13 +95,17 @@ class FlagMap {
         for (const auto& conditionFlag : plugin->getConditionFlags()) {
             flagList.emplace_back(toLower(conditionFlag.name), conditionFlag.value);
         }
+        markStale(flagList);
         flags[plugin] = flagList;
+        revision++;
     }
 
     void unsetFlagsForPlugin(PluginRef plugin)
     {
-        if (flags.contains(plugin)) {
-            flags.erase(plugin);
+        if (const auto it = flags.find(plugin); it != flags.end()) {
+            markStale(it->second);
+            flags.erase(it);
+            revision++;
         }
     }
 
@@ -98,10 +125,70 @@ class FlagMap {
         return result;
     }
 
-    void clearAll() { flags.clear(); }
+    void clearAll()
+    {
+        for (auto& state : keyStates | std::views::values) {
+            state.stale = true;
+        }
+        flags.clear();
+        revision++;
+    }
 
     [[nodiscard]] size_t getFlagCount() const { return flags.size(); }
 
   private:
+    struct KeyState {
+        std::optional<std::string> value;
+        uint64_t version { 0 };
+        bool stale { true };
+    };
+
     std::unordered_map<std::shared_ptr<PluginViewModel>, FlagList> flags;
+    mutable std::unordered_map<std::string, KeyState> keyStates; // Resolved lazily, by lower-case key
+    uint64_t revision { 0 };
+
+    const KeyState& getKeyState(const std::string& lowerKey) const
+    {
+        auto& state = keyStates[lowerKey];
+        if (state.stale) {
+            if (auto value = findFirstValue(lowerKey); value != state.value) {
+                state.value = std::move(value);
+                state.version++;
+            }
+            state.stale = false;
+        }
+        return state;
+    }
+
+    // The front of getFlagsByKey(lowerKey), without collecting and sorting the whole list
+    [[nodiscard]] std::optional<std::string> findFirstValue(const std::string& lowerKey) const
+    {
+        const PluginViewModel* winner = nullptr;
+        const std::string* value      = nullptr;
+        for (const auto& [plugin, theseFlags] : flags) {
+            if (winner != nullptr
+                && (plugin->getStepIndex() < winner->getStepIndex()
+                    || (plugin->getStepIndex() == winner->getStepIndex()
+                        && plugin->getOwnIndex() >= winner->getOwnIndex()))) {
+                continue;
+            }
+            for (const auto& [fst, snd] : theseFlags) {
+                if (fst == lowerKey) {
+                    winner = plugin.get();
+                    value  = &snd;
+                    break;
+                }
+            }
+        }
+        return value ? std::optional(*value) : std::nullopt;
+    }
+
+    void markStale(const FlagList& flagList) const
+    {
+        for (const auto& key : flagList | std::views::keys) {
+            if (const auto it = keyStates.find(key); it != keyStates.end()) {
+                it->second.stale = true;
+            }
+        }
+    }
 };
@@ -31,7 +31,7 @@ class PluginViewModel {
     [[nodiscard]] bool isSelected() const { return selected; }
     [[nodiscard]] bool isEnabled() const { return enabled; }
     [[nodiscard]] int getOwnIndex() const { return ownIndex; }
-    [[nodiscard]] std::vector<ConditionFlag> getConditionFlags() const { return plugin->conditionFlags.flags; }
+    [[nodiscard]] const std::vector<ConditionFlag>& getConditionFlags() const { return plugin->conditionFlags.flags; }
     [[nodiscard]] PluginTypeEnum getCurrentPluginType() const { return currentPluginType; }
     [[nodiscard]] bool wasManuallySet() const { return manuallySet; }
 
@@ -172,32 +172,34 @@ void FomodViewModel::createStepViewModels()
         return;
     }
 
+    // The view models share ownership of mFomodFile and point into it rather than each holding a copy of its part of
+    // the tree. Copies meant every plugin was held four times over (in the model, its plugin, its group and its step).
     for (int stepIndex = 0; stepIndex < mFomodFile->installSteps.installSteps.size(); ++stepIndex) {
-        const auto& installStep = mFomodFile->installSteps.installSteps[stepIndex];
+        auto& installStep = mFomodFile->installSteps.installSteps[stepIndex];
         shared_ptr_list<GroupViewModel> groupViewModels;
 
         for (int groupIndex = 0; groupIndex < installStep.optionalFileGroups.groups.size(); ++groupIndex) {
-            const auto& group = installStep.optionalFileGroups.groups[groupIndex];
+            auto& group = installStep.optionalFileGroups.groups[groupIndex];
             shared_ptr_list<PluginViewModel> pluginViewModels;
 
             for (int pluginIndex = 0; pluginIndex < group.plugins.plugins.size(); ++pluginIndex) {
-                const auto& plugin = group.plugins.plugins[pluginIndex];
-                auto pluginViewModel
-                    = std::make_shared<PluginViewModel>(std::make_shared<Plugin>(plugin), false, true, pluginIndex);
+                auto& plugin         = group.plugins.plugins[pluginIndex];
+                auto pluginViewModel = std::make_shared<PluginViewModel>(
+                    std::shared_ptr<Plugin>(mFomodFile, &plugin), false, true, pluginIndex);
 
                 pluginViewModel->setStepIndex(stepIndex);
                 pluginViewModel->setGroupIndex(groupIndex);
                 pluginViewModels.emplace_back(pluginViewModel); // Assuming default values for selected and enabled
             }
             auto groupViewModel = std::make_shared<GroupViewModel>(
-                std::make_shared<Group>(group), pluginViewModels, groupIndex, stepIndex);
+                std::shared_ptr<Group>(mFomodFile, &group), pluginViewModels, groupIndex, stepIndex);
             if (groupViewModel->getType() == SelectAtMostOne && groupViewModel->getPlugins().size() > 1) {
                 createNonePluginForGroup(groupViewModel);
             }
             groupViewModels.emplace_back(groupViewModel);
         }
         auto stepViewModel = std::make_shared<StepViewModel>(
-            std::make_shared<InstallStep>(installStep), std::move(groupViewModels), stepIndex);
+            std::shared_ptr<InstallStep>(mFomodFile, &installStep), std::move(groupViewModels), stepIndex);
         stepViewModels.emplace_back(stepViewModel);
     }
     mSteps = std::move(stepViewModels);
@@ -532,7 +534,7 @@ bool FomodViewModel::isFirstVisibleStep() const
 void FomodViewModel::preinstall(const std::shared_ptr<MOBase::IFileTree>& tree, const QString& fomodPath)
 {
     mFileInstaller
-        = std::make_shared<FileInstaller>(mOrganizer, fomodPath, tree, std::move(mFomodFile), mFlags, mSteps);
+        = std::make_shared<FileInstaller>(mOrganizer, fomodPath, tree, mFomodFile, mFlags, mSteps);
 }
 
 std::string FomodViewModel::getDisplayImage() const
@@ -107,7 +107,7 @@ class FomodViewModel {
   private:
     Logger& log                    = Logger::getInstance();
     MOBase::IOrganizer* mOrganizer = nullptr;
-    std::unique_ptr<ModuleConfiguration> mFomodFile;
+    std::shared_ptr<ModuleConfiguration> mFomodFile; // Shared with the view models, which point into it
     std::unique_ptr<FomodInfoFile> mInfoFile;
     std::shared_ptr<FlagMap> mFlags { nullptr };
     ConditionTester mConditionTester;
@@ -21,6 +21,8 @@
 #include "lib/PatchFinder.h"
 #include <FomodRescan.h>
 
+using namespace Qt::Literals::StringLiterals;
+
 // ── Init & Display ──────────────────────────────────────────────────────────
 
 bool FomodPlusPatchFinder::init(IOrganizer* organizer)
@@ -37,12 +39,31 @@ bool FomodPlusPatchFinder::init(IOrganizer* organizer)
         mPatchFinder->populateInstalledPlugins();
         mAvailablePatches = mPatchFinder->getAvailablePatchesForModList();
         loadDismissed();
+
+        // Keep the suggestions current between opens as mods and plugins change. A profile switch replaces the whole
+        // mod list and load order, so it gets a full rebuild, as does every open (see display()).
+        mOrganizer->onProfileChanged([this](IProfile*, IProfile*) { mPatchFinder->populateInstalledPlugins(); });
+        mOrganizer->modList()->onModInstalled([this](IModInterface* mod) { mPatchFinder->onModInstalled(mod); });
+        mOrganizer->modList()->onModRemoved([this](const QString& name) { mPatchFinder->onModRemoved(name); });
+        mOrganizer->modList()->onModStateChanged([this](const std::map<QString, IModList::ModStates>& mods) {
+            mPatchFinder->onModStateChanged(mods);
+        });
+        mOrganizer->pluginList()->onPluginStateChanged(
+            [this](const std::map<QString, IPluginList::PluginStates>& plugins) {
+                mPatchFinder->onPluginStateChanged(plugins);
+            });
         logMessage(DEBUG, "Available Patches: " + std::to_string(mAvailablePatches.size()));
     });
 
     return true;
 }
 
+QList<PluginSetting> FomodPlusPatchFinder::settings() const
+{
+    return { { u"rescan_workers"_s, u"Archives processed in parallel during a rescan (0 = one per CPU core)."_s, 0 },
+        { u"rescan_parallel_extractions"_s, u"Archives extracted at the same time during a rescan."_s, 2 } };
+}
+
 void FomodPlusPatchFinder::display() const
 {
     // Clear any existing layout
@@ -55,9 +76,10 @@ void FomodPlusPatchFinder::display() const
         delete mDialog->layout();
     }
 
-    // Reload the database and plugin list so we pick up any changes
-    // made by the installer since the last time the dialog was opened
-    mPatchFinder->mFomodDb->reload();
+    // Pick up DB changes made by the installer since the last time the dialog was opened, and rebuild the installed
+    // plugins. The change handlers registered in init() don't see mod renames or files added to or removed from an
+    // existing mod.
+    mPatchFinder->syncDatabase();
     mPatchFinder->populateInstalledPlugins();
     mAvailablePatches = mPatchFinder->getAvailablePatchesForModList();
 
@@ -275,10 +297,10 @@ void FomodPlusPatchFinder::populateSuggested(QWidget* container, const QString&
 
         auto* reinstallButton = new QPushButton(tr("Reinstall Mod"), groupFrame);
         reinstallButton->setFixedHeight(24);
-        const auto* entryPtr = entry.get();
-        connect(reinstallButton, &QPushButton::clicked, [this, entryPtr]() {
-            const_cast<FomodPlusPatchFinder*>(this)->onReinstallClicked(entryPtr);
-        });
+        connect(reinstallButton, &QPushButton::clicked,
+            [this, modId = entry->getModId(), displayName = entry->getDisplayName()]() {
+                const_cast<FomodPlusPatchFinder*>(this)->onReinstallClicked(modId, displayName);
+            });
         headerRow->addWidget(reinstallButton);
 
         groupLayout->addLayout(headerRow);
@@ -438,7 +460,7 @@ void FomodPlusPatchFinder::populateBrowseTree(QTreeWidget* tree, const QString&
             // Tooltip with step/group and masters
             QStringList tooltipParts;
             if (!option->step.empty() || !option->group.empty()) {
-                tooltipParts << QString::fromStdString(option->step + " > " + option->group);
+                tooltipParts << QString::fromStdString(option->step.str() + " > " + option->group.str());
             }
             if (!option->masters.empty()) {
                 QString mastersStr = tr("Masters: ");
@@ -460,35 +482,39 @@ void FomodPlusPatchFinder::populateBrowseTree(QTreeWidget* tree, const QString&
 
 // ── Reinstall Action ────────────────────────────────────────────────────────
 
-void FomodPlusPatchFinder::onReinstallClicked(const FomodDbEntry* entry)
+void FomodPlusPatchFinder::onReinstallClicked(const int modId, const std::string& displayName)
 {
+    // Resolve the entry through the DB index rather than holding a pointer that a reload would invalidate
+    const auto entry = mPatchFinder->mFomodDb->find(modId, displayName);
+    if (entry == nullptr) {
+        logMessage(WARN, "Reinstall requested for unknown entry: " + displayName);
+        return;
+    }
+
     logMessage(DEBUG, "Reinstall requested for: " + entry->getDisplayName());
 
-    // Look up the mod by Nexus mod ID first, fall back to display name
+    // Prefer the mod with a matching Nexus mod ID, fall back to display name. MO2 resolves names directly, so check
+    // the same-named mod before scanning the whole mod list by ID.
+    const auto modList               = mOrganizer->modList();
+    MOBase::IModInterface* namedMod  = modList->getMod(QString::fromStdString(entry->getDisplayName()));
     MOBase::IModInterface* targetMod = nullptr;
     const int targetModId            = entry->getModId();
 
-    for (const auto& modName : mOrganizer->modList()->allMods()) {
-        auto* mod = mOrganizer->modList()->getMod(modName);
-        if (mod == nullptr)
-            continue;
-
-        if (targetModId > 0 && mod->nexusId() == targetModId) {
-            targetMod = mod;
-            break;
+    if (namedMod != nullptr && (targetModId <= 0 || namedMod->nexusId() == targetModId)) {
+        targetMod = namedMod;
+    } else if (targetModId > 0) {
+        for (const auto& modName : modList->allMods()) {
+            auto* mod = modList->getMod(modName);
+            if (mod != nullptr && mod->nexusId() == targetModId) {
+                targetMod = mod;
+                break;
+            }
         }
     }
 
     // Fall back to display name matching
     if (targetMod == nullptr) {
-        const auto displayName = QString::fromStdString(entry->getDisplayName());
-        for (const auto& modName : mOrganizer->modList()->allMods()) {
-            auto* mod = mOrganizer->modList()->getMod(modName);
-            if (mod != nullptr && mod->name() == displayName) {
-                targetMod = mod;
-                break;
-            }
-        }
+        targetMod = namedMod;
     }
 
     if (targetMod == nullptr) {
@@ -526,10 +552,9 @@ void FomodPlusPatchFinder::onReinstallClicked(const FomodDbEntry* entry)
     // Trigger the installer — MO2 will route this through our FOMOD Plus installer
     mOrganizer->installMod(archivePath);
 
-    // Refresh data after reinstall — reload the DB from disk since the
-    // installer wrote updated selection states to a separate FomodDB instance
-    mPatchFinder->mFomodDb->reload();
-    mPatchFinder->populateInstalledPlugins();
+    // Refresh data after reinstall — the installer wrote updated selection states to a separate FomodDB instance.
+    // onModInstalled usually picked them up already, in which case this is a no-op.
+    mPatchFinder->syncDatabase();
     mAvailablePatches = mPatchFinder->getAvailablePatchesForModList();
 }
 
@@ -631,10 +656,15 @@ void FomodPlusPatchFinder::onRescanClicked()
     bool cancelled = false;
 
     // Perform the rescan
-    FomodRescan rescan(mOrganizer, mPatchFinder->mFomodDb.get());
+    RescanOptions options;
+    options.workers                  = mOrganizer->pluginSetting(name(), "rescan_workers").toUInt();
+    options.maxConcurrentExtractions = mOrganizer->pluginSetting(name(), "rescan_parallel_extractions").toUInt();
+
+    FomodRescan rescan(mOrganizer, mPatchFinder->mFomodDb.get(), options);
     auto result = rescan.scanAllModsWithChoices([&](int current, int total, const QString& modName) {
         if (progress.wasCanceled()) {
             cancelled = true;
+            rescan.cancel();
             return;
         }
         const int percent = total > 0 ? (current * 100 / total) : 0;
@@ -683,7 +713,7 @@ void FomodPlusPatchFinder::onRescanClicked()
     }
 
     // Refresh available patches
-    mPatchFinder->populateInstalledPlugins();
+    mPatchFinder->onDatabaseChanged(); // The rescan updated the DB in place
     mAvailablePatches = mPatchFinder->getAvailablePatchesForModList();
     logMessage(DEBUG, "Available Patches after rescan: " + std::to_string(mAvailablePatches.size()));
 
@@ -34,7 +34,7 @@ class FomodPlusPatchFinder final : public IPluginTool {
 
     [[nodiscard]] VersionInfo version() const override { return { 1, 0, 0, VersionInfo::RELEASE_BETA }; };
 
-    [[nodiscard]] QList<PluginSetting> settings() const override { return {}; };
+    [[nodiscard]] QList<PluginSetting> settings() const override;
 
     [[nodiscard]] QString displayName() const override { return tr("Patch Finder"); };
 
@@ -62,7 +62,7 @@ class FomodPlusPatchFinder final : public IPluginTool {
     void onRescanClicked();
     void populateSuggested(QWidget* container, const QString& filter) const;
     void populateBrowseTree(QTreeWidget* tree, const QString& filter) const;
-    void onReinstallClicked(const FomodDbEntry* entry);
+    void onReinstallClicked(int modId, const std::string& displayName);
     void onDismissClicked(int modId, const std::string& fileName);
 
     // Dismiss persistence
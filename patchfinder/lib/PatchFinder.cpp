@@ -1,75 +1,100 @@
-#include "PatchFinder.h"
+﻿#include "PatchFinder.h"
+
+#include <ranges>
+#include <set>
+
+namespace {
+// mDependentIndex key. Change handlers report names in MO2's casing, while the DB has them in FOMOD or master casing.
+StringId foldedName(const std::string_view name) { return StringId(toLower(std::string(name))); }
+
+StoredFileState toStoredState(const MOBase::IPluginList::PluginStates state)
+{
+    if (state & MOBase::IPluginList::STATE_ACTIVE) {
+        return StoredFileState::Active;
+    }
+    if (state & MOBase::IPluginList::STATE_INACTIVE) {
+        return StoredFileState::Inactive;
+    }
+    return StoredFileState::Missing;
+}
+}
 
 std::vector<AvailablePatch> PatchFinder::getAvailablePatchesForMod(const MOBase::IModInterface* mod)
 {
     std::vector<AvailablePatch> available_patches = {};
 
     // Verify that the mod has plugins in some shape or form.
-    if (const auto it = m_installedPlugins.find(mod); it == m_installedPlugins.end()) {
+    const auto modName = StringId::find(mod->name().toStdString());
+    if (!modName) {
         return available_patches;
     }
+    const auto* modPlugins = mInstalled.pluginsOf(*modName);
+    if (modPlugins == nullptr) {
+        return available_patches;
+    }
+
+    // Gather candidate options from the reverse index instead of scanning the whole database:
+    // 1. Masters-based: the patch lists this mod as a master
+    // 2. Condition-based: the patch has a file dependency referencing a plugin from this mod
+    std::vector<OptionRef> candidates;
+    const auto collect = [&candidates](const OptionIndex& index, const StringId key) {
+        if (const auto it = index.find(key); it != index.end()) {
+            candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+        }
+    };
+    collect(mMasterIndex, *modName);
+    for (const auto& modPlugin : *modPlugins) {
+        collect(mConditionIndex, modPlugin);
+    }
+
+    // Keep database order, and report an option once even if it matched several ways
+    std::ranges::sort(candidates);
+    const auto [dupesBegin, dupesEnd] = std::ranges::unique(candidates);
+    candidates.erase(dupesBegin, dupesEnd);
 
-    const auto modName = mod->name().toStdString();
+    // The same patch plugin often ships in several FOMODs (or several options of one). Its file name and header
+    // checksum identify it without reading the plugin, so it is suggested once, from the first option in DB order.
+    std::set<std::pair<std::string_view, uint32_t>> suggestedPlugins;
 
-    // Look through the database
-    for (const auto& fomodDbEntries = mFomodDb->getEntries(); const auto& entry : fomodDbEntries) {
-        for (const auto& option : entry->getOptions()) {
+    for (const auto& ref : candidates) {
+        const auto* candidate = optionAt(ref);
+        if (candidate == nullptr) {
+            continue;
+        }
+        const auto& entry  = mFomodDb->getEntries()[ref.entry];
+        const auto& option = *candidate;
+        {
             // Skip options that are already selected/installed
             if (option.selectionState == SelectionState::Selected) {
                 continue;
             }
 
             // If we have a specific plugin file, check if it's already installed
-            if (!option.fileName.empty()) {
-                const auto fileName = option.fileName.substr(option.fileName.find_last_of("/\\") + 1);
-                if (m_installedPluginsCacheSet.contains(fileName)) {
-                    continue;
-                }
-            }
-
-            // Check if this patch is related to the current mod:
-            // 1. Masters-based: the patch lists this mod as a master
-            bool masterRelated = std::ranges::any_of(
-                option.masters, [&modName](const std::string& master) { return master == modName; });
-
-            // 2. Condition-based: the patch has a file dependency referencing a plugin from this mod
-            bool conditionRelated = false;
-            if (!masterRelated && !option.typePatterns.empty()) {
-                if (const auto modIt = m_installedPlugins.find(mod); modIt != m_installedPlugins.end()) {
-                    for (const auto& modPlugin : modIt->second) {
-                        for (const auto& pattern : option.typePatterns) {
-                            if (std::ranges::any_of(pattern.dependencies.fileDependencies,
-                                    [&modPlugin](const StoredFileDependency& fd) {
-                                        return fd.file == modPlugin;
-                                    })) {
-                                conditionRelated = true;
-                                break;
-                            }
-                        }
-                        if (conditionRelated)
-                            break;
-                    }
-                }
-            }
-
-            if (!masterRelated && !conditionRelated) {
+            if (isPluginInstalled(option.fileName)) {
                 continue;
             }
 
             // Check if all masters are installed (existing logic)
             bool mastersMatch = !option.masters.empty()
                 && std::ranges::all_of(option.masters,
-                    [this](const std::string& master) { return m_installedPluginsCacheSet.contains(master); });
+                    [this](const StringId master) { return mInstalled.isInstalled(master); });
 
             // Check if conditions suggest this patch (new logic)
             bool conditionsMatch = false;
-            if (!option.typePatterns.empty() && mPluginStateResolver) {
-                auto resolvedType
-                    = ConditionEvaluator::resolveMatchingType(option.typePatterns, mPluginStateResolver);
-                conditionsMatch = (resolvedType == "Recommended" || resolvedType == "Required");
+            if (!option.conditionPrograms.empty()) {
+                auto resolvedType = ConditionEvaluator::resolveMatchingType(option, mInstalled.states());
+                conditionsMatch = (resolvedType == StoredPluginType::Recommended
+                    || resolvedType == StoredPluginType::Required);
             }
 
             if (mastersMatch || conditionsMatch) {
+                if (option.pluginHeader.known()) {
+                    const std::string_view path = option.fileName.str();
+                    const auto baseName         = path.substr(path.find_last_of("/\\") + 1);
+                    if (!suggestedPlugins.emplace(baseName, option.pluginHeader.checksum).second) {
+                        continue;
+                    }
+                }
                 AvailablePatch patch {
                     option, entry->getDisplayName(), mod->name().toStdString(),
                     false, // not installed
@@ -87,14 +112,17 @@ std::vector<AvailablePatch> PatchFinder::getAvailablePatchesForMod(const MOBase:
 std::vector<AvailablePatch> PatchFinder::getAvailablePatchesForModList()
 {
     std::vector<AvailablePatch> available_patches = {};
-    for (const auto& modName : m_organizer->modList()->allMods()) {
-        const auto mod = m_organizer->modList()->getMod(modName);
-        if (mod == nullptr) {
-            continue;
-        }
-        for (const auto& available_patch : getAvailablePatchesForMod(mod)) {
-            available_patches.emplace_back(available_patch);
+    for (const auto& name : m_organizer->modList()->allMods()) {
+        const StringId modName(name.toStdString());
+        auto cached = mPatchesByMod.find(modName);
+        if (cached == mPatchesByMod.end()) {
+            const auto mod = m_organizer->modList()->getMod(name);
+            if (mod == nullptr) {
+                continue;
+            }
+            cached = mPatchesByMod.emplace(modName, getAvailablePatchesForMod(mod)).first;
         }
+        available_patches.insert(available_patches.end(), cached->second.begin(), cached->second.end());
     }
 
     return available_patches;
@@ -107,56 +135,277 @@ bool PatchFinder::isSuggested(const FomodOption& option) const
         return false;
 
     // If we have a specific plugin fileName, check if it's already installed
-    if (!option.fileName.empty()) {
-        const auto fileName = option.fileName.substr(option.fileName.find_last_of("/\\") + 1);
-        if (m_installedPluginsCacheSet.contains(fileName))
-            return false;
-    }
+    if (isPluginInstalled(option.fileName))
+        return false;
 
     // Masters signal (existing logic) — requires a known plugin file
     const bool mastersMatch = !option.fileName.empty() && !option.masters.empty()
         && std::ranges::all_of(option.masters,
-            [this](const std::string& master) { return m_installedPluginsCacheSet.contains(master); });
+            [this](const StringId master) { return mInstalled.isInstalled(master); });
 
     // Conditions signal (first-match semantics) — works for both file and folder installs
     bool conditionsMatch = false;
-    if (!option.typePatterns.empty() && mPluginStateResolver) {
-        const auto resolvedType
-            = ConditionEvaluator::resolveMatchingType(option.typePatterns, mPluginStateResolver);
-        conditionsMatch = (resolvedType == "Recommended" || resolvedType == "Required");
+    if (!option.conditionPrograms.empty()) {
+        const auto resolvedType = ConditionEvaluator::resolveMatchingType(option, mInstalled.states());
+        conditionsMatch
+            = (resolvedType == StoredPluginType::Recommended || resolvedType == StoredPluginType::Required);
     }
 
     return mastersMatch || conditionsMatch;
 }
 
+bool PatchFinder::isPluginInstalled(const StringId fileName) const
+{
+    if (fileName.empty()) {
+        return false;
+    }
+    // The DB stores the archive-relative path; installed plugins are keyed by bare file name
+    const std::string_view path = fileName.str();
+    const auto baseName         = StringId::find(path.substr(path.find_last_of("/\\") + 1));
+    return baseName.has_value() && mInstalled.isInstalled(*baseName);
+}
+
+void PatchFinder::onDatabaseChanged()
+{
+    buildOptionIndex();
+    std::vector<StringId> changedFiles;
+    resolveConditionFiles(changedFiles);
+    mPatchesByMod.clear();
+}
+
+bool PatchFinder::syncDatabase()
+{
+    if (!mFomodDb->changedOnDisk()) {
+        return false;
+    }
+    logMessage(DEBUG, "DB changed on disk, reloading.");
+    mFomodDb->reload();
+    onDatabaseChanged();
+    return true;
+}
+
+void PatchFinder::buildOptionIndex()
+{
+    mMasterIndex.clear();
+    mConditionIndex.clear();
+    mDependentIndex.clear();
+    mConditionFiles.clear();
+
+    const auto& entries = mFomodDb->getEntries();
+    for (uint32_t entryIndex = 0; entryIndex < entries.size(); ++entryIndex) {
+        const auto& options = entries[entryIndex]->getOptions();
+        for (uint32_t optionIndex = 0; optionIndex < options.size(); ++optionIndex) {
+            const OptionRef ref { entryIndex, optionIndex };
+            const auto& option = options[optionIndex];
+            for (const auto& master : option.masters) {
+                mMasterIndex[master].push_back(ref);
+                mDependentIndex[foldedName(master.str())].push_back(ref);
+            }
+            for (const auto& pattern : option.typePatterns) {
+                for (const auto& fileDependency : pattern.dependencies.fileDependencies) {
+                    mConditionIndex[fileDependency.file].push_back(ref);
+                }
+            }
+
+            // isPluginInstalled() matches the option's own plugin by bare file name
+            if (!option.fileName.empty()) {
+                const std::string_view path = option.fileName.str();
+                mDependentIndex[foldedName(path.substr(path.find_last_of("/\\") + 1))].push_back(ref);
+            }
+            for (const auto& program : option.conditionPrograms) {
+                for (const auto& instruction : program.getCode()) {
+                    if (instruction.op != ConditionProgram::Op::Test) {
+                        continue;
+                    }
+                    mDependentIndex[foldedName(instruction.file.str())].push_back(ref);
+                    if (!isPluginFile(instruction.file.str())) {
+                        mConditionFiles.insert(instruction.file);
+                    }
+                }
+            }
+        }
+    }
+
+    // An option lands in a file's list once per reference; keep each option once
+    for (auto& refs : mDependentIndex | std::views::values) {
+        const auto [dupesBegin, dupesEnd] = std::ranges::unique(refs);
+        refs.erase(dupesBegin, dupesEnd);
+    }
+
+    logMessage(DEBUG,
+        "Indexed " + std::to_string(mMasterIndex.size()) + " masters and " + std::to_string(mConditionIndex.size())
+            + " condition files.");
+}
+
+const FomodOption* PatchFinder::optionAt(const OptionRef ref) const
+{
+    const auto& entries = mFomodDb->getEntries();
+    if (ref.entry >= entries.size() || ref.option >= entries[ref.entry]->getOptions().size()) {
+        return nullptr; // Stale index; onDatabaseChanged() rebuilds it after the DB changes
+    }
+    return &entries[ref.entry]->getOptions()[ref.option];
+}
+
 void PatchFinder::populateInstalledPlugins()
 {
-    m_installedPlugins.clear();
-    m_installedPluginsCacheSet.clear();
+    mInstalled.clear();
+    mPatchesByMod.clear();
 
+    // Nothing is being invalidated on a full rebuild, so the changed files are only collected and dropped
+    std::vector<StringId> changedFiles;
     for (const auto& modName : m_organizer->modList()->allMods()) {
-        const auto mod      = m_organizer->modList()->getMod(modName);
-        const auto mod_tree = mod->fileTree();
-        for (auto it = mod_tree->begin(); it != mod_tree->end(); ++it) {
-            if ((*it)->isFile() && isPluginFile((*it)->name())) {
-                std::cout << "Plugin: " << (*it)->name().toStdString() << std::endl;
-                m_installedPlugins[mod].emplace_back((*it)->name().toStdString());
-                m_installedPluginsCacheSet.insert((*it)->name().toStdString());
+        addModPlugins(m_organizer->modList()->getMod(modName), changedFiles);
+    }
+
+    // Plugins no mod provides (e.g. in the Data folder) are in the load order too
+    const auto pluginList = m_organizer->pluginList();
+    for (const auto& pluginName : pluginList->pluginNames()) {
+        setPluginState(pluginName, pluginList->state(pluginName), changedFiles);
+    }
+
+    // Conditions can also reference non-plugin files; resolve those against the VFS up front
+    resolveConditionFiles(changedFiles);
+}
+
+void PatchFinder::addModPlugins(const MOBase::IModInterface* mod, std::vector<StringId>& changedFiles)
+{
+    if (mod == nullptr) {
+        return;
+    }
+    std::vector<StringId> plugins;
+    const auto mod_tree = mod->fileTree();
+    for (auto it = mod_tree->begin(); it != mod_tree->end(); ++it) {
+        if ((*it)->isFile() && isPluginFile((*it)->name())) {
+            std::cout << "Plugin: " << (*it)->name().toStdString() << std::endl;
+            plugins.emplace_back((*it)->name().toStdString());
+        }
+    }
+    mInstalled.addMod(StringId(mod->name().toStdString()), plugins, loadOrderState(), changedFiles);
+}
+
+void PatchFinder::removeModPlugins(const StringId modName, std::vector<StringId>& changedFiles)
+{
+    mInstalled.removeMod(modName, loadOrderState(), changedFiles);
+}
+
+InstalledPlugins::LoadOrderState PatchFinder::loadOrderState() const
+{
+    // MO2 doesn't report a state change for a plugin that stays in the load order while its mod is reinstalled, so
+    // adding or removing a mod asks for the state of each of its plugins
+    return [pluginList = m_organizer->pluginList()](const StringId plugin) {
+        return toStoredState(pluginList->state(QString::fromStdString(plugin.str())));
+    };
+}
+
+void PatchFinder::setPluginState(
+    const QString& pluginName, const MOBase::IPluginList::PluginStates state, std::vector<StringId>& changedFiles)
+{
+    mInstalled.setState(StringId(pluginName.toStdString()), toStoredState(state), changedFiles);
+}
+
+void PatchFinder::resolveConditionFiles(std::vector<StringId>& changedFiles)
+{
+    for (const auto& file : mConditionFiles) {
+        const auto state = m_organizer->resolvePath(QString::fromStdString(file)).isEmpty()
+            ? StoredFileState::Missing
+            : StoredFileState::Active;
+        mInstalled.setState(file, state, changedFiles);
+    }
+}
+
+void PatchFinder::invalidate(const std::vector<StringId>& changedFiles)
+{
+    for (const auto& file : changedFiles) {
+        const auto refs = mDependentIndex.find(foldedName(file.str()));
+        if (refs == mDependentIndex.end()) {
+            continue;
+        }
+        for (const auto& ref : refs->second) {
+            const auto* option = optionAt(ref);
+            if (option == nullptr) {
+                continue;
+            }
+            // Drop the mods this option can be listed under (see getAvailablePatchesForMod): mods named as one of
+            // its masters, and mods providing a file its top-level conditions test.
+            for (const auto& master : option->masters) {
+                mPatchesByMod.erase(master);
+            }
+            for (const auto& pattern : option->typePatterns) {
+                for (const auto& fileDependency : pattern.dependencies.fileDependencies) {
+                    if (const auto* owners = mInstalled.ownersOf(fileDependency.file)) {
+                        for (const auto& owner : *owners) {
+                            mPatchesByMod.erase(owner);
+                        }
+                    }
+                }
             }
         }
     }
+}
+
+void PatchFinder::onModInstalled(const MOBase::IModInterface* mod)
+{
+    // The installer commits its DB entry before MO2 reports the install
+    syncDatabase();
 
-    // Create a cached resolver for condition evaluation using the live plugin list
-    mPluginStateResolver = makeCachedResolver([this](const std::string& fileName) -> std::string {
-        if (!isPluginFile(fileName)) {
-            const auto resolved = m_organizer->resolvePath(QString::fromStdString(fileName));
-            return resolved.isEmpty() ? "Missing" : "Active";
+    const StringId modName(mod->name().toStdString());
+    std::vector<StringId> changedFiles;
+    removeModPlugins(modName, changedFiles); // A reinstall replaces the previous files
+    addModPlugins(mod, changedFiles);
+    resolveConditionFiles(changedFiles);
+
+    mPatchesByMod.erase(modName);
+    invalidate(changedFiles);
+    logMessage(
+        DEBUG, "Mod installed: " + modName.str() + ", " + std::to_string(changedFiles.size()) + " files changed.");
+}
+
+void PatchFinder::onModRemoved(const QString& modName)
+{
+    const auto name = StringId::find(modName.toStdString());
+    if (!name) {
+        return;
+    }
+    std::vector<StringId> changedFiles;
+    removeModPlugins(*name, changedFiles);
+    resolveConditionFiles(changedFiles);
+
+    mPatchesByMod.erase(*name);
+    invalidate(changedFiles);
+    logMessage(DEBUG, "Mod removed: " + name->str() + ", " + std::to_string(changedFiles.size()) + " files changed.");
+}
+
+void PatchFinder::onModStateChanged(const std::map<QString, MOBase::IModList::ModStates>& mods)
+{
+    // Enabling or disabling a mod changes which of its plugins are in the load order and which files the VFS has
+    std::vector<StringId> changedFiles;
+    const auto pluginList = m_organizer->pluginList();
+    for (const auto& modName : mods | std::views::keys) {
+        const auto name = StringId::find(modName.toStdString());
+        if (!name) {
+            continue;
+        }
+        if (const auto* plugins = mInstalled.pluginsOf(*name)) {
+            for (const auto& plugin : *plugins) {
+                const auto pluginName = QString::fromStdString(plugin);
+                setPluginState(pluginName, pluginList->state(pluginName), changedFiles);
+            }
         }
-        const auto state = m_organizer->pluginList()->state(QString::fromStdString(fileName));
-        if (state & MOBase::IPluginList::STATE_ACTIVE)
-            return "Active";
-        if (state & MOBase::IPluginList::STATE_INACTIVE)
-            return "Inactive";
-        return "Missing";
-    });
+    }
+    resolveConditionFiles(changedFiles);
+
+    invalidate(changedFiles);
+    logMessage(DEBUG,
+        std::to_string(mods.size()) + " mod states changed, " + std::to_string(changedFiles.size())
+            + " files changed.");
+}
+
+void PatchFinder::onPluginStateChanged(const std::map<QString, MOBase::IPluginList::PluginStates>& plugins)
+{
+    std::vector<StringId> changedFiles;
+    for (const auto& [pluginName, state] : plugins) {
+        setPluginState(pluginName, state, changedFiles);
+    }
+
+    invalidate(changedFiles);
 }
@@ -4,11 +4,16 @@
 
 #include <ConditionEvaluator.h>
 #include <FomodDb.h>
+#include <InstalledPlugins.h>
 #include <ifiletree.h>
 #include <imodinterface.h>
+#include <imodlist.h>
 #include <imoinfo.h>
 #include <ipluginlist.h>
 
+#include <map>
+#include <unordered_set>
+
 struct AvailablePatch {
     FomodOption fomod_option;
     std::string installer_name;
@@ -27,24 +32,83 @@ class PatchFinder {
     {
         mFomodDb = std::make_unique<FomodDB>(m_organizer->basePath().toStdString());
         logMessage(DEBUG, "mFomodDb loaded.");
+        buildOptionIndex();
     }
 
+    /**
+     * Rebuild everything derived from the DB. Call after the DB is modified in place (e.g. by a rescan).
+     */
+    void onDatabaseChanged();
+
+    /**
+     * Reload the DB if another instance (e.g. the installer) wrote to it since it was last loaded. Mod and plugin
+     * data are kept; only the suggestions are recomputed.
+     * @return true if the DB was reloaded.
+     */
+    bool syncDatabase();
+
     std::vector<AvailablePatch> getAvailablePatchesForMod(const MOBase::IModInterface* mod);
+
+    /**
+     * @return Suggestions for every mod, in mod list order. Served from the per-mod cache that the change handlers
+     * below keep current; only mods without a cached result are evaluated.
+     */
     std::vector<AvailablePatch> getAvailablePatchesForModList();
     bool isSuggested(const FomodOption& option) const;
 
+    // Change handlers, wired to MO2's mod list and plugin list callbacks. Each one updates the installed plugins and
+    // the load order snapshot for what changed, then re-evaluates only the mods whose candidate options mention it.
+    void onModInstalled(const MOBase::IModInterface* mod);
+    void onModRemoved(const QString& modName);
+    void onModStateChanged(const std::map<QString, MOBase::IModList::ModStates>& mods);
+    void onPluginStateChanged(const std::map<QString, MOBase::IPluginList::PluginStates>& plugins);
+
   protected:
+    void buildOptionIndex();
     void populateInstalledPlugins();
+    [[nodiscard]] bool isPluginInstalled(StringId fileName) const;
 
   private:
     Logger& log = Logger::getInstance();
     MOBase::IOrganizer* m_organizer;
     std::unique_ptr<FomodDB> mFomodDb;
 
-    // Map of { pluginPtr: [1.esp, 2.esp, 3.esp] }
-    std::unordered_map<const MOBase::IModInterface*, std::vector<std::string>> m_installedPlugins;
-    std::unordered_set<std::string> m_installedPluginsCacheSet;
-    PluginStateResolver mPluginStateResolver;
+    // Which mod provides which plugin, and the load order state of every plugin and condition file.
+    InstalledPlugins mInstalled;
+    // Non-plugin files tested by conditions; their state comes from the VFS rather than the plugin list.
+    std::unordered_set<StringId> mConditionFiles;
+
+    // Suggestions per mod name, as returned by getAvailablePatchesForMod(). A missing entry means "not evaluated".
+    std::unordered_map<StringId, std::vector<AvailablePatch>> mPatchesByMod;
+
+    // Position of an option in the DB: getEntries()[entry]->getOptions()[option].
+    struct OptionRef {
+        uint32_t entry;
+        uint32_t option;
+
+        auto operator<=>(const OptionRef&) const = default;
+    };
+    using OptionIndex = std::unordered_map<StringId, std::vector<OptionRef>>;
+
+    // Reverse indexes built when the DB loads, so a mod only visits the options that can reference it.
+    // Master name -> options listing it as a master.
+    OptionIndex mMasterIndex;
+    // Plugin name -> options whose top-level conditions test it.
+    OptionIndex mConditionIndex;
+    // Case-folded file name -> every option whose result can change with it: as a master, as its own plugin file, or
+    // as any file its conditions test. Used to find what to re-evaluate when a file changes.
+    OptionIndex mDependentIndex;
+
+    // Helpers for the change handlers. Each appends the files whose installed state or load order state actually
+    // changed to changedFiles, so invalidate() can drop only the suggestions that depend on them.
+    void addModPlugins(const MOBase::IModInterface* mod, std::vector<StringId>& changedFiles);
+    void removeModPlugins(StringId modName, std::vector<StringId>& changedFiles);
+    void setPluginState(const QString& pluginName, MOBase::IPluginList::PluginStates state,
+        std::vector<StringId>& changedFiles);
+    [[nodiscard]] InstalledPlugins::LoadOrderState loadOrderState() const;
+    void resolveConditionFiles(std::vector<StringId>& changedFiles);
+    void invalidate(const std::vector<StringId>& changedFiles);
+    [[nodiscard]] const FomodOption* optionAt(OptionRef ref) const;
 
     void logMessage(const LogLevel level, const std::string& message) const
     {
@@ -4,6 +4,7 @@
 #include "archiveparser.h"
 
 #include <QDialog>
+#include <QEventLoop>
 #include <QMessageBox>
 #include <QProgressBar>
 #include <QPushButton>
@@ -13,6 +14,8 @@
 #include <QLabel>
 #include <QMovie>
 #include <iostream>
+#include <optional>
+#include <thread>
 
 #include "stringutil.h"
 
@@ -47,17 +50,25 @@ bool FomodPlusScanner::init(IOrganizer* organizer)
     mProgressBar->setRange(0, 100); // Updated to actual mod count when scan starts
     mProgressBar->setVisible(false);
 
-    const auto scanButton   = new QPushButton(tr("Scan"), mDialog);
+    mFullScanCheckBox = new QCheckBox(tr("Full scan (also re-open archives that haven't changed)"), mDialog);
+    mFullScanCheckBox->setChecked(false);
+
+    mDryRunCheckBox = new QCheckBox(tr("Dry run (only report which mods would change)"), mDialog);
+    mDryRunCheckBox->setChecked(false);
+
+    mScanButton             = new QPushButton(tr("Scan"), mDialog);
     const auto cancelButton = new QPushButton(tr("Cancel"), mDialog);
 
     layout->addWidget(descriptionLabel, 1);
     layout->addWidget(gifLabel, 1);
     layout->addWidget(mProgressBar, 1);
-    layout->addWidget(scanButton, 1);
+    layout->addWidget(mFullScanCheckBox);
+    layout->addWidget(mDryRunCheckBox);
+    layout->addWidget(mScanButton, 1);
     layout->addWidget(cancelButton, 1);
 
-    connect(cancelButton, &QPushButton::clicked, mDialog, &QDialog::reject);
-    connect(scanButton, &QPushButton::clicked, this, &FomodPlusScanner::onScanClicked);
+    connect(cancelButton, &QPushButton::clicked, this, &FomodPlusScanner::onCancelClicked);
+    connect(mScanButton, &QPushButton::clicked, this, &FomodPlusScanner::onScanClicked);
     connect(mDialog, &QDialog::finished, this, &FomodPlusScanner::cleanup);
 
     mDialog->setLayout(layout);
@@ -69,15 +80,65 @@ bool FomodPlusScanner::init(IOrganizer* organizer)
 
 void FomodPlusScanner::onScanClicked() const
 {
-    if (mOrganizer->modList()) {
-        mProgressBar->setRange(0, static_cast<int>(mOrganizer->modList()->allMods().size()));
-    }
     mProgressBar->setVisible(true);
-    const int added = scanLoadOrder(setFomodInfoForMod);
+    mScanButton->setEnabled(false);
+    const auto mode   = mFullScanCheckBox->isChecked() ? ScanMode::Full : ScanMode::Incremental;
+    const auto dryRun = mDryRunCheckBox->isChecked();
+
+    // Collect every change first and only write once the scan is done, so a scan that changes nothing writes nothing
+    std::vector<FomodSettingChange> changes;
+    const auto summary = scanLoadOrder(
+        [&changes](IModInterface* mod, const ScanResult result) {
+            if (auto value = fomodInfoChangeForMod(mod, result)) {
+                changes.push_back({ mod, std::move(*value) });
+                return true;
+            }
+            return false;
+        },
+        mode);
+    mScanButton->setEnabled(true);
     mDialog->accept();
-    QMessageBox::information(mDialog, tr("Scan Complete"),
-        tr("The load order scan is complete. Updated filter info for ") + QString::number(added) + tr(" mods."));
-    mOrganizer->refresh();
+
+    const auto title    = mCancelled ? tr("Scan Cancelled") : tr("Scan Complete");
+    const auto outcome  = mCancelled ? tr("The load order scan was cancelled.") : tr("The load order scan is done.");
+    const auto archives = tr("Opened %1 archives; %2 were unchanged since the last scan.")
+                              .arg(summary.probed)
+                              .arg(summary.unchanged);
+    if (dryRun) {
+        constexpr qsizetype maxListed = 20;
+        QStringList names;
+        for (const auto& change : changes) {
+            if (names.size() == maxListed) {
+                names.append(tr("...and %1 more").arg(changes.size() - maxListed));
+                break;
+            }
+            names.append(change.mod->name());
+        }
+        auto message = outcome + " " + archives + "\n\n"
+            + tr("Dry run: filter info would change for %1 mods.").arg(changes.size());
+        if (!names.isEmpty()) {
+            message += "\n\n" + names.join("\n");
+        }
+        QMessageBox::information(mDialog, title, message);
+        return;
+    }
+
+    const int written = applyFomodInfoChanges(changes);
+    QMessageBox::information(
+        mDialog, title, outcome + " " + tr("Updated filter info for %1 mods.").arg(written) + " " + archives);
+    if (written > 0) {
+        mOrganizer->refresh();
+    }
+}
+
+void FomodPlusScanner::onCancelClicked() const
+{
+    // While scanning, stop handing out archives; scanLoadOrder() returns once the workers finish their current one
+    if (mScanning) {
+        mCancelled = true;
+        return;
+    }
+    mDialog->reject();
 }
 
 void FomodPlusScanner::cleanup() const
@@ -88,42 +149,128 @@ void FomodPlusScanner::cleanup() const
 
 void FomodPlusScanner::display() const { mDialog->exec(); }
 
-int FomodPlusScanner::scanLoadOrder(const ScanCallbackFn& callback) const
+ScanSummary FomodPlusScanner::scanLoadOrder(const ScanCallbackFn& callback, const ScanMode mode) const
 {
-    int progress = 0;
-    int modified = 0;
+    ScanSummary summary;
+
+    // Archives that haven't changed since the last scan or rescan aren't opened again
+    ArchiveMetadataCache archiveCache(QDir(mOrganizer->basePath()).filePath(ARCHIVE_CACHE_FILE).toStdString());
+
+    // Gather what the workers need from MO2 first; its interfaces are only used from this thread. Mods without an
+    // archive, and in incremental mode mods whose archive is unchanged, are resolved right here.
+    const auto downloadsDir = mOrganizer->downloadsPath();
+    std::vector<IModInterface*> mods;
+    std::vector<std::optional<ScanResult>> results;
+    std::vector<size_t> pending; // Indexes into mods
+    std::vector<QString> archivePaths;
+    std::vector<QString> modNames;
     for (const auto& modName : mOrganizer->modList()->allMods()) {
         const auto mod = mOrganizer->modList()->getMod(modName);
-        if (const ScanResult result = openInstallationArchive(mod); callback(mod, result)) {
-            modified++;
+        if (!mod) {
+            continue;
+        }
+        mods.push_back(mod);
+        auto& result = results.emplace_back();
+
+        const auto installationFile = mod->installationFile();
+        if (installationFile.isEmpty()) {
+            result = ScanResult::NO_ARCHIVE;
+            continue;
         }
-        mProgressBar->setValue(++progress);
+        const auto archivePath = ArchiveParser::qualifyArchivePath(downloadsDir, installationFile);
+        if (mode == ScanMode::Incremental) {
+            if ((result = ArchiveParser::findCached(archiveCache, archivePath))) {
+                summary.unchanged++;
+                continue;
+            }
+        }
+        pending.push_back(mods.size() - 1);
+        archivePaths.push_back(archivePath);
+        modNames.push_back(mod->name());
     }
-    return modified;
-}
+    mProgressBar->setRange(0, static_cast<int>(pending.size()));
 
-ScanResult FomodPlusScanner::openInstallationArchive(const IModInterface* mod) const
-{
-    const auto downloadsDir         = mOrganizer->downloadsPath();
-    const auto installationFilePath = mod->installationFile();
-    return ArchiveParser::scanForFomodFiles(downloadsDir, installationFilePath, mod->name());
+    // Workers post each result back to this thread, which keeps running its event loop meanwhile so the dialog
+    // repaints and the Cancel button works. Results are only handed to callback once every worker is done.
+    std::atomic<size_t> next = 0;
+    int progress             = 0;
+    size_t workersDone       = 0;
+    QEventLoop loop;
+
+    const auto workerCount = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), pending.size());
+    const auto worker      = [&] {
+        const auto archive = CreateArchive(); // Reused for every archive this worker opens
+        for (size_t job = next++; job < pending.size() && !mCancelled; job = next++) {
+            const auto result = ArchiveParser::probeArchive(archivePaths[job], modNames[job], *archive, &archiveCache);
+            QMetaObject::invokeMethod(
+                mProgressBar,
+                [&, job, result] {
+                    results[pending[job]] = result;
+                    mProgressBar->setValue(++progress);
+                },
+                Qt::QueuedConnection);
+        }
+        // Queued after this worker's results, so they are all recorded by the time the loop quits
+        QMetaObject::invokeMethod(
+            mProgressBar,
+            [&] {
+                if (++workersDone == workerCount) {
+                    loop.quit();
+                }
+            },
+            Qt::QueuedConnection);
+    };
+
+    mCancelled = false;
+    mScanning  = true;
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; ++i) {
+            workers.emplace_back(worker);
+        }
+        if (workerCount > 0) {
+            loop.exec();
+        }
+    }
+    mScanning      = false;
+    summary.probed = progress;
+
+    for (size_t i = 0; i < mods.size(); ++i) {
+        if (results[i] && callback(mods[i], *results[i])) {
+            summary.modified++;
+        }
+    }
+    archiveCache.save();
+    return summary;
 }
 
-bool FomodPlusScanner::setFomodInfoForMod(IModInterface* mod, const ScanResult result)
+std::optional<QVariant> FomodPlusScanner::fomodInfoChangeForMod(const IModInterface* mod, const ScanResult result)
 {
     const auto pluginName = "FOMOD Plus";
     const auto setting    = mod->pluginSetting(pluginName, "fomod", 0);
     if (setting == 0 && ScanResult::HAS_FOMOD == result) {
-        return mod->setPluginSetting(pluginName, "fomod", "{}");
+        return QVariant("{}");
     }
     if (setting != 0 && ScanResult::NO_FOMOD == result) {
         // Only clear if the existing setting is a bare flag ("{}") set by a previous scan.
         // Never clear rich JSON data written by the installer — those are user choices.
         if (setting.toString() == "{}") {
-            return mod->setPluginSetting(pluginName, "fomod", 0);
+            return QVariant(0);
+        }
+    }
+    return std::nullopt;
+}
+
+int FomodPlusScanner::applyFomodInfoChanges(const std::vector<FomodSettingChange>& changes)
+{
+    int written = 0;
+    for (const auto& [mod, value] : changes) {
+        if (mod->setPluginSetting("FOMOD Plus", "fomod", value)) {
+            written++;
         }
     }
-    return false;
+    return written;
 }
 
 bool FomodPlusScanner::removeFomodInfoFromMod(IModInterface* mod, ScanResult)
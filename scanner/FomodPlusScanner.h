@@ -6,11 +6,33 @@
 #include <iplugin.h>
 #include <iplugintool.h>
 
+#include <QCheckBox>
 #include <QDialog>
 #include <QProgressBar>
+#include <QPushButton>
+#include <QVariant>
+#include <atomic>
+#include <optional>
+#include <vector>
 
 using namespace MOBase;
 
+enum class ScanMode {
+    Incremental, // Only open archives that are new or changed since the last scan
+    Full         // Open every archive again
+};
+
+struct ScanSummary {
+    int modified  = 0; // Mods the callback returned true for
+    int probed    = 0; // Archives opened
+    int unchanged = 0; // Mods whose archive was unchanged since the last scan, so it wasn't opened
+};
+
+struct FomodSettingChange {
+    IModInterface* mod;
+    QVariant value; // New value of the mod's "fomod" plugin setting; 0 clears it
+};
+
 class FomodPlusScanner final : public IPluginTool {
     Q_OBJECT
     Q_INTERFACES(MOBase::IPlugin MOBase::IPluginTool)
@@ -30,6 +52,8 @@ class FomodPlusScanner final : public IPluginTool {
 
     void onScanClicked() const;
 
+    void onCancelClicked() const;
+
     void cleanup() const;
 
     [[nodiscard]] QString name() const override { return "FOMOD Scanner"; } // This should not be translated
@@ -47,18 +71,39 @@ class FomodPlusScanner final : public IPluginTool {
 
     void display() const override;
 
-    int scanLoadOrder(const std::function<bool(IModInterface*, ScanResult result)>& callback) const;
-
-    ScanResult openInstallationArchive(const IModInterface* mod) const;
-
-    static bool setFomodInfoForMod(IModInterface* mod, ScanResult result);
+    /**
+     * Open every mod's installation archive on a pool of workers, keeping the UI responsive. Once the workers are
+     * done, callback is called on this thread for each scanned mod, in mod list order. A cancelled scan still reports
+     * the mods scanned so far.
+     * @param mode Incremental reuses the result of the last scan for archives that haven't changed since.
+     */
+    ScanSummary scanLoadOrder(const std::function<bool(IModInterface*, ScanResult result)>& callback,
+        ScanMode mode = ScanMode::Incremental) const;
+
+    /**
+     * Work out how a scan result changes a mod's "fomod" setting, without writing anything.
+     * @return The new value, or nullopt if the current value already matches the result.
+     */
+    static std::optional<QVariant> fomodInfoChangeForMod(const IModInterface* mod, ScanResult result);
+
+    /**
+     * Write a change set collected from fomodInfoChangeForMod. Every setting write rewrites that mod's meta.ini,
+     * which is why changes are collected first and only the real differences are written.
+     * @return The number of settings written.
+     */
+    static int applyFomodInfoChanges(const std::vector<FomodSettingChange>& changes);
 
     static bool removeFomodInfoFromMod(IModInterface* mod, ScanResult);
 
   private:
     QDialog* mDialog { nullptr };
     QProgressBar* mProgressBar { nullptr };
+    QPushButton* mScanButton { nullptr };
+    QCheckBox* mFullScanCheckBox { nullptr };
+    QCheckBox* mDryRunCheckBox { nullptr };
     IOrganizer* mOrganizer { nullptr };
+    mutable std::atomic<bool> mScanning { false };
+    mutable std::atomic<bool> mCancelled { false };
 };
 
 #endif // FOMODPLUSSCANNER_H
\ No newline at end of file
@@ -1,10 +1,14 @@
 ﻿#pragma once
+#include "ArchiveMetadataCache.h"
 #include "stringutil.h"
 
 #include <QDir>
 #include <QString>
+#include <algorithm>
 #include <archive.h>
+#include <chrono>
 #include <iostream>
+#include <optional>
 #include <ostream>
 
 inline std::ostream& operator<<(std::ostream& os, const Archive::Error& error)
@@ -28,20 +32,12 @@ inline std::ostream& operator<<(std::ostream& os, const Archive::Error& error)
     return os;
 }
 
+// Stops at the first ModuleConfig.xml. Entry paths are only compared in place, never converted or lower-cased.
 inline bool hasFomodFiles(const std::vector<FileData*>& files)
 {
-    bool hasModuleXml = false;
-    bool hasInfoXml   = false;
-
-    for (const auto* file : files) {
-        if (endsWithCaseInsensitive(file->getArchiveFilePath(), StringConstants::FomodFiles::W_MODULE_CONFIG.data())) {
-            hasModuleXml = true;
-        }
-        if (endsWithCaseInsensitive(file->getArchiveFilePath(), StringConstants::FomodFiles::W_INFO_XML.data())) {
-            hasInfoXml = true;
-        }
-    }
-    return hasModuleXml;
+    return std::ranges::any_of(files, [](const FileData* file) {
+        return endsWithPathCaseInsensitive(file->getArchiveFilePath(), StringConstants::FomodFiles::W_MODULE_CONFIG);
+    });
 }
 
 /* This class can do the following:
@@ -57,38 +53,71 @@ enum class ScanResult { HAS_FOMOD, NO_FOMOD, NO_ARCHIVE };
 
 class ArchiveParser {
   public:
-    static ScanResult scanForFomodFiles(
-        const QString& downloadsPath, const QString& installationFilePath, const QString& modName)
+    /**
+     * Open the archive and look for FOMOD files, whether or not cache already knows the answer.
+     * @param archive Archive handle to open the file with. It is closed again before returning.
+     * @param cache Optional archive metadata cache to record the result in.
+     */
+    static ScanResult probeArchive(
+        const QString& archivePath, const QString& modName, Archive& archive, ArchiveMetadataCache* cache = nullptr)
     {
-        if (installationFilePath.isEmpty()) {
-            return ScanResult::NO_ARCHIVE;
-        }
-        const auto qualifiedInstallerPath = QDir(installationFilePath).isAbsolute()
-            ? installationFilePath
-            : downloadsPath + "/" + installationFilePath;
-
-        const auto archive = CreateArchive();
+        const auto probeStart = std::chrono::steady_clock::now();
 
-        if (!archive->isValid()) {
+        if (!archive.isValid()) {
             logErrorForMod(modName, "Failed to load the archive module ", archive);
             return ScanResult::NO_ARCHIVE;
         }
-        if (!archive->open(qualifiedInstallerPath.toStdWString(), nullptr)) {
-            logErrorForMod(modName, "Failed to open archive [" + qualifiedInstallerPath + "]", archive);
+        if (!archive.open(archivePath.toStdWString(), nullptr)) {
+            logErrorForMod(modName, "Failed to open archive [" + archivePath + "]", archive);
             return ScanResult::NO_ARCHIVE;
         }
 
-        if (hasFomodFiles(archive->getFileList())) {
-            std::cout << "Found FOMOD files in " << qualifiedInstallerPath.toStdString() << std::endl;
-            return ScanResult::HAS_FOMOD;
+        const auto hasFomod = hasFomodFiles(archive.getFileList());
+        archive.close();
+        if (cache) {
+            cache->storeHasFomod(archivePath, hasFomod);
+        }
+        logProbe(modName, archivePath, hasFomod, std::chrono::steady_clock::now() - probeStart);
+        return hasFomod ? ScanResult::HAS_FOMOD : ScanResult::NO_FOMOD;
+    }
+
+    /**
+     * @return The result of the last scan of the archive, if it hasn't changed since.
+     */
+    static std::optional<ScanResult> findCached(const ArchiveMetadataCache& cache, const QString& archivePath)
+    {
+        if (const auto cached = cache.find(archivePath)) {
+            return cached->hasFomod ? ScanResult::HAS_FOMOD : ScanResult::NO_FOMOD;
         }
-        return ScanResult::NO_FOMOD;
+        return std::nullopt;
+    }
+
+    // Installation files are stored relative to the downloads directory unless the archive was installed from
+    // elsewhere.
+    static QString qualifyArchivePath(const QString& downloadsPath, const QString& installationFilePath)
+    {
+        return QDir(installationFilePath).isAbsolute() ? installationFilePath
+                                                       : downloadsPath + "/" + installationFilePath;
     }
 
   private:
-    static void logErrorForMod(const QString& modName, const QString& message, const std::unique_ptr<Archive>& archive)
+    // Probes slower than this are flagged in the log, so archives worth repacking or excluding stand out.
+    static constexpr auto SLOW_PROBE = std::chrono::milliseconds(500);
+
+    static void logProbe(const QString& modName, const QString& archivePath, const bool hasFomod,
+        const std::chrono::steady_clock::duration elapsed)
+    {
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+        // One write per line, since workers log concurrently
+        std::cout << ("[" + modName.toStdString() + "] Probed " + archivePath.toStdString() + " in "
+                         + std::to_string(ms) + " ms" + (hasFomod ? ", found FOMOD files" : "")
+                         + (elapsed >= SLOW_PROBE ? " (slow)" : "") + "\n")
+                  << std::flush;
+    }
+
+    static void logErrorForMod(const QString& modName, const QString& message, const Archive& archive)
     {
-        std::cerr << "[" << modName.toStdString() << "] " << message.toStdString() << " (" << archive->getLastError()
+        std::cerr << "[" << modName.toStdString() << "] " << message.toStdString() << " (" << archive.getLastError()
                   << ")" << std::endl;
     }
 };
\ No newline at end of file
@@ -1,11 +1,15 @@
 #pragma once
 
+#include "ArchiveMetadataCache.h"
+#include "ExtractionScratch.h"
+#include "PluginReader.h"
 #include "stringutil.h"
 
 #include <QDir>
 #include <QFileInfo>
 #include <QString>
 #include <QTemporaryDir>
+#include <algorithm>
 #include <archive.h>
 #include <filesystem>
 #include <functional>
@@ -17,8 +21,21 @@ struct ExtractionResult {
     bool success = false;
     QString moduleConfigPath;
     std::vector<QString> pluginPaths;
+    std::vector<ExtractedPlugin> pluginEntries;  // How the archive lists each of pluginPaths; headers are empty
+    std::vector<ExtractedPlugin> skippedPlugins; // Plugins the filter left in the archive; headers are empty
+    QString errorMessage;
+    QString directory;                      // Where the files were extracted to
+    std::unique_ptr<QTemporaryDir> tempDir; // Owns the temp directory lifetime; null when extracted into a scratch
+};
+
+/**
+ * FOMOD data extracted into memory. Nothing on disk refers to it once it is returned.
+ */
+struct InMemoryExtractionResult {
+    bool success = false;
+    std::vector<char> moduleConfig; // Raw ModuleConfig.xml, for ModuleConfiguration::deserialize(span)
+    std::vector<ExtractedPlugin> plugins;
     QString errorMessage;
-    std::unique_ptr<QTemporaryDir> tempDir; // Owns the temp directory lifetime
 };
 
 /**
@@ -28,23 +45,40 @@ struct ExtractionResult {
 class ArchiveExtractor {
   public:
     using ProgressCallback = std::function<void(const QString& fileName)>;
+    // Decides per plugin (by its path, size and CRC in the archive; the header is still empty) whether it has to be
+    // extracted at all.
+    using PluginFilter = std::function<bool(const ExtractedPlugin& plugin)>;
 
     /**
      * Extract ModuleConfig.xml and plugin files from an archive.
      * @param archiveFilePath Full path to the archive file
      * @param progressCallback Optional callback for progress updates
+     * @param pluginFilter Optional; plugins it rejects are not extracted and are listed in skippedPlugins instead
+     * @param scratch Optional; extract into this reusable directory instead of a new temporary one. Its previous
+     * contents are deleted first, and the extracted files stay there until the scratch is cleared or reused.
      * @return ExtractionResult containing paths to extracted files
      */
-    static ExtractionResult extractFomodData(
-        const QString& archiveFilePath, const ProgressCallback& progressCallback = nullptr)
+    static ExtractionResult extractFomodData(const QString& archiveFilePath,
+        const ProgressCallback& progressCallback = nullptr, const PluginFilter& pluginFilter = nullptr,
+        ExtractionScratch* scratch = nullptr)
     {
         ExtractionResult result;
-        result.tempDir = std::make_unique<QTemporaryDir>();
-
-        if (!result.tempDir->isValid()) {
-            result.errorMessage = "Failed to create temporary directory";
-            return result;
+        if (scratch) {
+            if (!scratch->isValid()) {
+                result.errorMessage = "Failed to create scratch directory";
+                return result;
+            }
+            scratch->begin();
+            result.directory = scratch->path();
+        } else {
+            result.tempDir = std::make_unique<QTemporaryDir>();
+            if (!result.tempDir->isValid()) {
+                result.errorMessage = "Failed to create temporary directory";
+                return result;
+            }
+            result.directory = result.tempDir->path();
         }
+        const QDir outputDir(result.directory);
 
         const auto archive = CreateArchive();
         if (!archive->isValid()) {
@@ -61,25 +95,42 @@ class ArchiveExtractor {
         // Get file list and mark files for extraction
         const auto& fileList = archive->getFileList();
         QString moduleConfigInArchive;
+        uint64_t bytesToExtract = 0;
 
         for (auto* fileData : fileList) {
-            const auto entryPath = QString::fromStdWString(fileData->getArchiveFilePath());
+            // Most entries are neither; test the wide path in place before converting anything
+            const auto archivePath = fileData->getArchiveFilePath();
+            const bool isModuleConfig
+                = endsWithPathCaseInsensitive(archivePath, StringConstants::FomodFiles::W_MODULE_CONFIG);
+            if (!isModuleConfig && !isPluginFile(std::wstring_view(archivePath))) {
+                continue;
+            }
+            const auto entryPath = QString::fromStdWString(archivePath);
 
             // Check for ModuleConfig.xml
-            if (entryPath.toLower().endsWith("fomod/moduleconfig.xml")
-                || entryPath.toLower().endsWith("fomod\\moduleconfig.xml")) {
+            if (isModuleConfig) {
                 moduleConfigInArchive = entryPath;
                 // Set output path relative to output directory for extract()
                 fileData->addOutputFilePath(L"ModuleConfig.xml");
-                result.moduleConfigPath = result.tempDir->filePath("ModuleConfig.xml");
+                result.moduleConfigPath = outputDir.filePath("ModuleConfig.xml");
+                bytesToExtract += fileData->getSize();
             }
-            // Check for plugin files - preserve full path to avoid collisions
-            else if (isPluginFile(entryPath)) {
+            // Plugin files - preserve full path to avoid collisions
+            else {
+                ExtractedPlugin plugin;
+                plugin.archivePath = QString(entryPath).replace('\\', '/').toStdString();
+                plugin.size        = fileData->getSize();
+                plugin.crc         = fileData->getCRC();
+                if (pluginFilter && !pluginFilter(plugin)) {
+                    result.skippedPlugins.push_back(std::move(plugin));
+                    continue;
+                }
                 // Use full archive path to preserve uniqueness (different options may have same-named plugins)
-                auto relativePath = QString("plugins/") + entryPath;
-                relativePath.replace('\\', '/'); // Normalize path separators
+                const auto relativePath = QString("plugins/") + QString::fromStdString(plugin.archivePath);
                 fileData->addOutputFilePath(relativePath.toStdWString());
-                result.pluginPaths.push_back(result.tempDir->filePath(relativePath));
+                result.pluginPaths.push_back(outputDir.filePath(relativePath));
+                result.pluginEntries.push_back(std::move(plugin));
+                bytesToExtract += fileData->getSize();
             }
         }
 
@@ -88,8 +139,17 @@ class ArchiveExtractor {
             return result;
         }
 
-        // Create plugins subdirectory
-        QDir(result.tempDir->path()).mkpath("plugins");
+        if (scratch && !scratch->fits(bytesToExtract)) {
+            result.errorMessage = QString("FOMOD files need %1 bytes, more than the scratch size cap of %2")
+                                      .arg(bytesToExtract)
+                                      .arg(*scratch->sizeCap());
+            return result;
+        }
+
+        // Create plugins subdirectory; a scratch keeps it between extractions
+        if (!scratch) {
+            outputDir.mkpath("plugins");
+        }
 
         // Extract the files
         Archive::FileChangeCallback fileChangeCallback
@@ -103,8 +163,14 @@ class ArchiveExtractor {
             = [&result](const std::wstring& error) { result.errorMessage = QString::fromStdWString(error); };
 
         const bool extractSuccess
-            = archive->extract(result.tempDir->path().toStdWString(), Archive::ProgressCallback {}, // progress callback
+            = archive->extract(result.directory.toStdWString(), Archive::ProgressCallback {}, // progress callback
                 fileChangeCallback, errorCallback);
+        if (scratch) {
+            scratch->recordWritten(result.moduleConfigPath);
+            for (const auto& path : result.pluginPaths) {
+                scratch->recordWritten(path);
+            }
+        }
 
         if (!extractSuccess) {
             if (result.errorMessage.isEmpty()) {
@@ -121,12 +187,67 @@ class ArchiveExtractor {
 
         // Filter to only existing plugin files
         std::vector<QString> existingPlugins;
-        for (const auto& path : result.pluginPaths) {
-            if (QFile::exists(path)) {
-                existingPlugins.push_back(path);
+        std::vector<ExtractedPlugin> existingEntries;
+        for (size_t i = 0; i < result.pluginPaths.size(); ++i) {
+            if (QFile::exists(result.pluginPaths[i])) {
+                existingPlugins.push_back(result.pluginPaths[i]);
+                existingEntries.push_back(std::move(result.pluginEntries[i]));
             }
         }
-        result.pluginPaths = std::move(existingPlugins);
+        result.pluginPaths   = std::move(existingPlugins);
+        result.pluginEntries = std::move(existingEntries);
+
+        result.success = true;
+        return result;
+    }
+
+    /**
+     * Extract ModuleConfig.xml and the header record of every plugin into memory.
+     *
+     * The archive library can only extract to a directory, so the files pass through a temporary directory, or through
+     * scratch when one is given. Every file is read back and deleted before this returns. Parsing then happens entirely
+     * in memory, and only the few KB of each plugin's TES4 record are held, however large the plugin is.
+     * Plugins rejected by pluginFilter are never decompressed. They are still listed in plugins, with an empty header,
+     * so callers can match them against the FOMOD and take their masters from elsewhere (e.g. a MastersCache).
+     * @param archiveFilePath Full path to the archive file
+     * @param pluginFilter Optional; decides which plugins need their header read
+     * @param scratch Optional; reusable directory to extract into, e.g. one per rescan worker
+     * @return The extracted data, or success = false with an errorMessage
+     */
+    static InMemoryExtractionResult extractFomodDataToMemory(const QString& archiveFilePath,
+        const PluginFilter& pluginFilter = nullptr, ExtractionScratch* scratch = nullptr)
+    {
+        InMemoryExtractionResult result;
+
+        auto extracted = extractFomodData(archiveFilePath, nullptr, pluginFilter, scratch);
+        if (!extracted.success) {
+            result.errorMessage = extracted.errorMessage;
+            return result;
+        }
+
+        QFile moduleConfig(extracted.moduleConfigPath);
+        if (!moduleConfig.open(QIODevice::ReadOnly)) {
+            result.errorMessage = "Failed to read extracted ModuleConfig.xml";
+            return result;
+        }
+        const auto xml = moduleConfig.readAll();
+        result.moduleConfig.assign(xml.begin(), xml.end());
+        moduleConfig.close();
+
+        result.plugins.reserve(extracted.pluginPaths.size() + extracted.skippedPlugins.size());
+        for (size_t i = 0; i < extracted.pluginPaths.size(); ++i) {
+            auto& plugin  = result.plugins.emplace_back(std::move(extracted.pluginEntries[i]));
+            plugin.header = PluginReader::readHeaderRecord(extracted.pluginPaths[i].toStdString());
+        }
+        for (auto& plugin : extracted.skippedPlugins) {
+            result.plugins.push_back(std::move(plugin));
+        }
+
+        // Delete the scratch files now rather than whenever the caller is done with the result
+        if (scratch) {
+            scratch->clear();
+        }
+        extracted.tempDir.reset();
 
         result.success = true;
         return result;
@@ -135,22 +256,29 @@ class ArchiveExtractor {
     /**
      * Check if an archive contains FOMOD files without extracting.
      * @param archiveFilePath Full path to the archive file
+     * @param cache Optional archive metadata cache, consulted first and updated after opening the archive
      * @return true if the archive contains fomod/ModuleConfig.xml
      */
-    static bool hasFomodFiles(const QString& archiveFilePath)
+    static bool hasFomodFiles(const QString& archiveFilePath, ArchiveMetadataCache* cache = nullptr)
     {
+        if (cache) {
+            if (const auto cached = cache->find(archiveFilePath)) {
+                return cached->hasFomod;
+            }
+        }
+
         const auto archive = CreateArchive();
         if (!archive->isValid() || !archive->open(archiveFilePath.toStdWString(), nullptr)) {
             return false;
         }
 
-        for (const auto* fileData : archive->getFileList()) {
-            const auto path = QString::fromStdWString(fileData->getArchiveFilePath());
-            if (path.toLower().endsWith("fomod/moduleconfig.xml")
-                || path.toLower().endsWith("fomod\\moduleconfig.xml")) {
-                return true;
-            }
+        const bool hasFomod = std::ranges::any_of(archive->getFileList(), [](const FileData* fileData) {
+            return endsWithPathCaseInsensitive(
+                fileData->getArchiveFilePath(), StringConstants::FomodFiles::W_MODULE_CONFIG);
+        });
+        if (cache) {
+            cache->storeHasFomod(archiveFilePath, hasFomod);
         }
-        return false;
+        return hasFomod;
     }
 };
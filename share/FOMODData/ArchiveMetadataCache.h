@@ -0,0 +1,272 @@
+#pragma once
+
+#include "BinaryIO.h"
+#include "FomodDBBinary.h"
+
+#include <QString>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+constexpr const char* ARCHIVE_CACHE_FILE = "fomod.archives.cache";
+
+/*
+Persistent cache of what FOMOD Plus learned from each download archive, so an archive that hasn't changed since the
+last scan or rescan is never opened again.
+
+Records are keyed by the archive's path and validated against its size and modification time; a record for an
+archive that changed on disk is ignored and replaced. Each record stores whether the archive has a FOMOD and, once a
+rescan has parsed it, the DB entry built from its ModuleConfig.xml before any user choices are applied.
+
+    File
+        char[4]  magic      "FMDA"
+        uint32   version    ArchiveMetadataCache::VERSION
+        uint32   checksum   fnv1a32(body)
+        uint32   count
+        Record   records[count]
+
+    Record
+        uint32   pathLength, char path[pathLength]
+        uint64   size
+        int64    modified   file_time_type ticks
+        uint8    flags      HAS_FOMOD | PARSED
+        uint32   entryLength
+        byte     entry[entryLength]   single-entry FomodDBBinary, PARSED records with options only
+
+It is only a cache: a missing, corrupt or outdated file simply starts empty.
+*/
+
+class ArchiveMetadataCache {
+  public:
+    static constexpr char MAGIC[4]    = { 'F', 'M', 'D', 'A' };
+    static constexpr uint32_t VERSION = 2; // 2: entries carry plugin headers
+
+    struct Metadata {
+        bool hasFomod = false;
+        bool parsed   = false; // entry below is known; only rescans parse archives
+        std::shared_ptr<FomodDbEntry> entry; // nullptr if not parsed, or the FOMOD has no options
+    };
+
+    explicit ArchiveMetadataCache(std::string cacheFilePath)
+        : path(std::move(cacheFilePath))
+    {
+        load();
+    }
+
+    /**
+     * @return The cached metadata for the archive, if there is a record and the archive hasn't changed since. The entry
+     * is shared with the cache; copy it before modifying it.
+     */
+    [[nodiscard]] std::optional<Metadata> find(const QString& archivePath) const
+    {
+        const auto stamp = statArchive(archivePath);
+        if (!stamp) {
+            return std::nullopt;
+        }
+        std::shared_lock lock(mutex);
+        const auto it = records.find(makeKey(archivePath));
+        if (it == records.end() || it->second.size != stamp->size || it->second.modified != stamp->modified) {
+            return std::nullopt;
+        }
+        return it->second.metadata;
+    }
+
+    /**
+     * Record whether the archive has a FOMOD. Keeps an existing parsed record for the same archive version.
+     */
+    void storeHasFomod(const QString& archivePath, const bool hasFomod)
+    {
+        if (const auto cached = find(archivePath); cached && cached->hasFomod == hasFomod) {
+            return;
+        }
+        store(archivePath, { hasFomod, false, nullptr });
+    }
+
+    /**
+     * Record the parsed FOMOD of an archive.
+     * @param entry The entry as built from ModuleConfig.xml, before applying choices; nullptr if it has no options.
+     * It is copied, so the caller can go on to modify its own.
+     */
+    void storeParsed(const QString& archivePath, const std::shared_ptr<FomodDbEntry>& entry)
+    {
+        store(archivePath, { true, true, entry ? std::make_shared<FomodDbEntry>(*entry) : nullptr });
+    }
+
+    /**
+     * Write the cache back to disk if anything changed, dropping records for archives that no longer exist.
+     */
+    bool save()
+    {
+        std::unique_lock lock(mutex);
+        if (!dirty) {
+            return true;
+        }
+        std::erase_if(records, [](const auto& record) {
+            std::error_code ec;
+            return !std::filesystem::exists(record.second.archivePath, ec);
+        });
+
+        BinaryWriter body;
+        body.write<uint32_t>(static_cast<uint32_t>(records.size()));
+        for (const auto& [key, record] : records) {
+            writeString(body, key);
+            body.write<uint64_t>(record.size);
+            body.write<int64_t>(record.modified);
+            body.write<uint8_t>((record.metadata.hasFomod ? HAS_FOMOD : 0) | (record.metadata.parsed ? PARSED : 0));
+            if (record.metadata.entry) {
+                const auto entry = FomodDBBinary::serialize({ record.metadata.entry });
+                body.write<uint32_t>(static_cast<uint32_t>(entry.size()));
+                body.writeBytes({ entry.data(), entry.size() });
+            } else {
+                body.write<uint32_t>(0);
+            }
+        }
+
+        BinaryWriter header;
+        header.writeBytes({ MAGIC, sizeof(MAGIC) });
+        header.write<uint32_t>(VERSION);
+        header.write<uint32_t>(fnv1a32({ body.buffer().data(), body.size() }));
+
+        const auto tempFilePath = path + ".tmp";
+        {
+            std::ofstream file(tempFilePath, std::ios::binary | std::ios::trunc);
+            file.write(header.buffer().data(), static_cast<std::streamsize>(header.size()));
+            file.write(body.buffer().data(), static_cast<std::streamsize>(body.size()));
+            if (!file.good()) {
+                return false;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(tempFilePath, path, ec);
+        if (ec) {
+            std::filesystem::remove(tempFilePath, ec);
+            return false;
+        }
+        dirty = false;
+        return true;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        std::shared_lock lock(mutex);
+        return records.size();
+    }
+
+  private:
+    static constexpr uint8_t HAS_FOMOD  = 1 << 0;
+    static constexpr uint8_t PARSED     = 1 << 1;
+    static constexpr size_t HEADER_SIZE = sizeof(MAGIC) + 2 * sizeof(uint32_t);
+
+    struct Stamp {
+        uint64_t size;
+        int64_t modified;
+    };
+
+    struct Record {
+        std::filesystem::path archivePath;
+        uint64_t size    = 0;
+        int64_t modified = 0;
+        Metadata metadata;
+    };
+
+    std::string path;
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, Record> records;
+    bool dirty = false;
+
+    static std::filesystem::path toPath(const QString& archivePath)
+    {
+        return std::filesystem::path(archivePath.toStdWString());
+    }
+
+    // Archive paths come from MO2 with either separator and arbitrary case; Windows treats them all the same.
+    static std::string makeKey(const QString& archivePath)
+    {
+        return QString(archivePath).replace('\\', '/').toLower().toStdString();
+    }
+
+    static std::optional<Stamp> statArchive(const QString& archivePath)
+    {
+        std::error_code ec;
+        const auto archive = toPath(archivePath);
+        const auto size    = std::filesystem::file_size(archive, ec);
+        if (ec) {
+            return std::nullopt;
+        }
+        const auto modified = std::filesystem::last_write_time(archive, ec);
+        if (ec) {
+            return std::nullopt;
+        }
+        return Stamp { size, static_cast<int64_t>(modified.time_since_epoch().count()) };
+    }
+
+    void store(const QString& archivePath, Metadata metadata)
+    {
+        const auto stamp = statArchive(archivePath);
+        if (!stamp) {
+            return;
+        }
+        std::unique_lock lock(mutex);
+        records[makeKey(archivePath)] = { toPath(archivePath), stamp->size, stamp->modified, std::move(metadata) };
+        dirty                         = true;
+    }
+
+    static void writeString(BinaryWriter& out, const std::string_view str)
+    {
+        out.write<uint32_t>(static_cast<uint32_t>(str.size()));
+        out.writeBytes(str);
+    }
+
+    void load()
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return;
+        }
+        const std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (bytes.size() < HEADER_SIZE || std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) != 0) {
+            return;
+        }
+
+        BinaryReader header(std::span<const char>(bytes), sizeof(MAGIC));
+        const auto version  = header.read<uint32_t>();
+        const auto checksum = header.read<uint32_t>();
+        const std::span<const char> body(bytes.data() + HEADER_SIZE, bytes.size() - HEADER_SIZE);
+        if (version != VERSION || checksum != fnv1a32({ body.data(), body.size() })) {
+            return; // Outdated or corrupt; start over
+        }
+
+        BinaryReader reader(body);
+        const auto count = reader.read<uint32_t>();
+        for (uint32_t i = 0; i < count && !reader.failed(); ++i) {
+            const auto key = reader.readBytes(reader.read<uint32_t>());
+            Record record;
+            record.size     = reader.read<uint64_t>();
+            record.modified = reader.read<int64_t>();
+
+            const auto flags         = reader.read<uint8_t>();
+            record.metadata.hasFomod = (flags & HAS_FOMOD) != 0;
+            record.metadata.parsed   = (flags & PARSED) != 0;
+
+            const auto entryBytes = reader.readBytes(reader.read<uint32_t>());
+            if (reader.failed()) {
+                break;
+            }
+            if (!entryBytes.empty()) {
+                std::vector<std::shared_ptr<FomodDbEntry>> entries;
+                if (!FomodDBBinary::deserialize({ entryBytes.data(), entryBytes.size() }, entries)
+                    || entries.size() != 1) {
+                    continue;
+                }
+                record.metadata.entry = entries.front();
+            }
+            record.archivePath = std::filesystem::path(std::u8string(key.begin(), key.end()));
+            records.emplace(std::string(key), std::move(record));
+        }
+    }
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * 32-bit FNV-1a. Cheap integrity check for on-disk records; not a cryptographic hash.
+ */
+inline uint32_t fnv1a32(const std::string_view bytes)
+{
+    uint32_t hash = 2166136261u;
+    for (const char c : bytes) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * 64-bit FNV-1a, for keying content (e.g. a ModuleConfig.xml) where 32 bits would collide too easily.
+ */
+inline uint64_t fnv1a64(const std::string_view bytes)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const char c : bytes) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * Minimal little-endian binary writer used by the on-disk FOMOD Plus formats.
+ * Values are written in host byte order; every platform MO2 supports is little-endian.
+ */
+class BinaryWriter {
+  public:
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void write(const T& value)
+    {
+        const auto offset = mBuffer.size();
+        mBuffer.resize(offset + sizeof(T));
+        std::memcpy(mBuffer.data() + offset, &value, sizeof(T));
+    }
+
+    void writeBytes(const std::string_view bytes) { mBuffer.insert(mBuffer.end(), bytes.begin(), bytes.end()); }
+
+    /**
+     * Overwrite a value previously written at the given offset. Used to back-patch offsets and counts.
+     */
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void patch(const size_t offset, const T& value)
+    {
+        std::memcpy(mBuffer.data() + offset, &value, sizeof(T));
+    }
+
+    [[nodiscard]] size_t size() const { return mBuffer.size(); }
+    [[nodiscard]] const std::vector<char>& buffer() const { return mBuffer; }
+    [[nodiscard]] std::vector<char> release() { return std::move(mBuffer); }
+
+  private:
+    std::vector<char> mBuffer;
+};
+
+/**
+ * Bounds-checked reader over a byte span (typically a memory-mapped file).
+ * Reads past the end never touch memory; they flip the reader into a failed state instead.
+ */
+class BinaryReader {
+  public:
+    explicit BinaryReader(const std::span<const char> data, const size_t offset = 0)
+        : mData(data)
+        , mOffset(offset)
+        , mFailed(offset > data.size())
+    {
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    T read()
+    {
+        T value {};
+        if (!canRead(sizeof(T))) {
+            mFailed = true;
+            return value;
+        }
+        std::memcpy(&value, mData.data() + mOffset, sizeof(T));
+        mOffset += sizeof(T);
+        return value;
+    }
+
+    std::string_view readBytes(const size_t length)
+    {
+        if (!canRead(length)) {
+            mFailed = true;
+            return {};
+        }
+        const std::string_view bytes(mData.data() + mOffset, length);
+        mOffset += length;
+        return bytes;
+    }
+
+    void seek(const size_t offset)
+    {
+        if (offset > mData.size()) {
+            mFailed = true;
+            return;
+        }
+        mOffset = offset;
+    }
+
+    void fail() { mFailed = true; }
+
+    [[nodiscard]] bool canRead(const size_t length) const
+    {
+        return !mFailed && mOffset <= mData.size() && length <= mData.size() - mOffset;
+    }
+
+    [[nodiscard]] size_t offset() const { return mOffset; }
+    [[nodiscard]] size_t remaining() const { return mFailed ? 0 : mData.size() - mOffset; }
+    [[nodiscard]] bool failed() const { return mFailed; }
+
+  private:
+    std::span<const char> mData;
+    size_t mOffset;
+    bool mFailed;
+};
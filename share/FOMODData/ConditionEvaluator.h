@@ -3,21 +3,24 @@
 #include "FomodDBEntry.h"
 
 #include <functional>
+#include <optional>
 #include <string>
 #include <unordered_map>
 
-// Callback: given a filename, return its state ("Active", "Inactive", "Missing")
-using PluginStateResolver = std::function<std::string(const std::string& fileName)>;
+// Callback: given a filename, return its state (Active, Inactive, Missing)
+using PluginStateResolver = std::function<StoredFileState(const std::string& fileName)>;
 
-// Creates a caching wrapper around a PluginStateResolver to avoid repeated lookups
+// Creates a caching wrapper around a PluginStateResolver to avoid repeated lookups. The plugins no longer use it since
+// the Patch Finder moved to PluginStateSnapshot; it stays as the reference resolver the snapshot is tested and
+// benchmarked against.
 inline PluginStateResolver makeCachedResolver(PluginStateResolver inner)
 {
-    auto cache = std::make_shared<std::unordered_map<std::string, std::string>>();
-    return [inner = std::move(inner), cache](const std::string& fileName) -> std::string {
+    auto cache = std::make_shared<std::unordered_map<std::string, StoredFileState>>();
+    return [inner = std::move(inner), cache](const std::string& fileName) -> StoredFileState {
         if (auto it = cache->find(fileName); it != cache->end()) {
             return it->second;
         }
-        auto result          = inner(fileName);
+        auto result        = inner(fileName);
         (*cache)[fileName] = result;
         return result;
     };
@@ -33,36 +36,35 @@ inline bool evaluateFileDependency(const StoredFileDependency& dep, const Plugin
 // Evaluates a StoredDependencies block against the resolver.
 // Flag dependencies are skipped (not evaluable outside the installer).
 // Returns false if there are no evaluable conditions (flag-only blocks).
+// Stops at the first child that decides the block's operator.
 inline bool evaluateDependencies(const StoredDependencies& deps, const PluginStateResolver& resolver)
 {
-    std::vector<bool> results;
-
-    for (const auto& fd : deps.fileDependencies) {
-        results.push_back(evaluateFileDependency(fd, resolver));
+    // If no evaluable conditions exist, this block provides no signal
+    if (deps.fileDependencies.empty() && deps.nestedDependencies.empty()) {
+        return false;
     }
 
     // Flag dependencies are intentionally skipped — session-local, not evaluable
 
-    for (const auto& nd : deps.nestedDependencies) {
-        results.push_back(evaluateDependencies(nd, resolver));
-    }
-
-    // If no evaluable conditions exist, this block provides no signal
-    if (results.empty()) {
-        return false;
+    const bool isOr = deps.operatorType == StoredOperator::Or;
+    for (const auto& fd : deps.fileDependencies) {
+        if (evaluateFileDependency(fd, resolver) == isOr) {
+            return isOr;
+        }
     }
-
-    if (deps.operatorType == "Or") {
-        return std::ranges::any_of(results, [](bool r) { return r; });
+    for (const auto& nd : deps.nestedDependencies) {
+        if (evaluateDependencies(nd, resolver) == isOr) {
+            return isOr;
+        }
     }
-    return std::ranges::all_of(results, [](bool r) { return r; });
+    return !isOr;
 }
 
 // First-match semantics: returns the type of the first pattern whose conditions pass.
-// Returns empty string if no pattern matches.
+// Returns nullopt if no pattern matches.
 // Patterns without file or nested dependencies (static fallbacks, flag-only) are
 // skipped since they can't be evaluated against the load order.
-inline std::string resolveMatchingType(
+inline std::optional<StoredPluginType> resolveMatchingType(
     const std::vector<StoredTypePattern>& patterns, const PluginStateResolver& resolver)
 {
     for (const auto& pattern : patterns) {
@@ -81,7 +83,20 @@ inline std::string resolveMatchingType(
             return pattern.type;
         }
     }
-    return {};
+    return std::nullopt;
+}
+
+// Same first-match semantics as above, using the option's precompiled condition programs.
+// This is the hot path: the Patch Finder runs it for every option on each refresh.
+template <typename Resolver>
+std::optional<StoredPluginType> resolveMatchingType(const FomodOption& option, Resolver&& resolver)
+{
+    for (const auto& program : option.conditionPrograms) {
+        if (program.isEvaluable() && program.evaluate(resolver)) {
+            return program.getType();
+        }
+    }
+    return std::nullopt;
 }
 
 } // namespace ConditionEvaluator
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <QFileInfo>
+#include <QString>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <system_error>
+
+/*
+One reusable scratch directory for ArchiveExtractor, so processing many archives doesn't create and delete a temporary
+directory tree (and have it scanned by antivirus) for every one of them. Each rescan worker owns one and clears it
+between archives. Not thread-safe; never share one between workers.
+
+Layout: <root>/ModuleConfig.xml and <root>/plugins/<path in archive>. The root and plugins/ survive clear(); only the
+files extracted into them are deleted.
+*/
+
+class ExtractionScratch {
+  public:
+    struct Stats {
+        uint64_t extractions    = 0; // Times the directory was reused
+        uint64_t bytesWritten   = 0; // Total size of all files recorded with recordWritten()
+        uint64_t bytesReclaimed = 0; // Total size of the files deleted by clear()
+        uint64_t peakBytes      = 0; // Most bytes held at once
+
+        Stats& operator+=(const Stats& other)
+        {
+            extractions += other.extractions;
+            bytesWritten += other.bytesWritten;
+            bytesReclaimed += other.bytesReclaimed;
+            peakBytes = std::max(peakBytes, other.peakBytes);
+            return *this;
+        }
+    };
+
+    /**
+     * @param sizeCap Optional; the most bytes a single extraction may write into the directory.
+     */
+    explicit ExtractionScratch(const std::optional<uint64_t> sizeCap = std::nullopt)
+        : mSizeCap(sizeCap)
+    {
+        if (mDir.isValid()) {
+            std::error_code ec;
+            std::filesystem::create_directories(pluginsDir(), ec);
+        }
+    }
+
+    ExtractionScratch(const ExtractionScratch&)            = delete;
+    ExtractionScratch& operator=(const ExtractionScratch&) = delete;
+
+    [[nodiscard]] bool isValid() const { return mDir.isValid(); }
+
+    [[nodiscard]] QString path() const { return mDir.path(); }
+
+    [[nodiscard]] QString filePath(const QString& relativePath) const { return mDir.filePath(relativePath); }
+
+    /**
+     * @return true if an extraction writing this many bytes stays within the size cap.
+     */
+    [[nodiscard]] bool fits(const uint64_t bytes) const { return !mSizeCap || bytes <= *mSizeCap; }
+
+    [[nodiscard]] std::optional<uint64_t> sizeCap() const { return mSizeCap; }
+
+    /**
+     * Start a new extraction: deletes whatever the previous one left behind.
+     */
+    void begin()
+    {
+        clear();
+        mStats.extractions++;
+    }
+
+    /**
+     * Account for a file that was extracted into the directory.
+     */
+    void recordWritten(const QString& filePath)
+    {
+        const auto size = static_cast<uint64_t>(QFileInfo(filePath).size());
+        mStats.bytesWritten += size;
+        mHeldBytes += size;
+        mStats.peakBytes = std::max(mStats.peakBytes, mHeldBytes);
+    }
+
+    /**
+     * Delete every extracted file in one pass, keeping the root and plugins/ for the next extraction.
+     */
+    void clear()
+    {
+        if (!mDir.isValid()) {
+            return;
+        }
+        const std::filesystem::path root = mDir.path().toStdWString();
+        const auto plugins               = pluginsDir();
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(root, ec)) {
+            if (entry.path() == plugins) {
+                for (const auto& child : std::filesystem::directory_iterator(plugins, ec)) {
+                    std::filesystem::remove_all(child.path(), ec);
+                }
+            } else {
+                std::filesystem::remove_all(entry.path(), ec);
+            }
+        }
+        mStats.bytesReclaimed += mHeldBytes;
+        mHeldBytes = 0;
+    }
+
+    [[nodiscard]] uint64_t heldBytes() const { return mHeldBytes; }
+
+    [[nodiscard]] const Stats& stats() const { return mStats; }
+
+  private:
+    QTemporaryDir mDir;
+    std::optional<uint64_t> mSizeCap;
+    uint64_t mHeldBytes = 0;
+    Stats mStats;
+
+    [[nodiscard]] std::filesystem::path pluginsDir() const
+    {
+        return std::filesystem::path(mDir.path().toStdWString()) / "plugins";
+    }
+};
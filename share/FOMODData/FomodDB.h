@@ -1,22 +1,30 @@
 ﻿#pragma once
 
 #include <fstream>
+#include <iostream>
+#include <optional>
 #include <stringutil.h>
 #include <unordered_map>
 
+#include <QFile>
 #include <QFileInfo>
 
+#include "FomodDBBinary.h"
 #include "FomodDBEntry.h"
+#include "FomodDBJournal.h"
+#include "MastersCache.h"
 
 #include <xml/ModuleConfiguration.h>
 
 #include "PluginReader.h"
 
 using FOMODDBEntries = std::vector<std::shared_ptr<FomodDbEntry>>;
-using MastersCache   = std::unordered_map<std::string, std::vector<std::string>>; // filename -> masters
 
 constexpr const char* FOMOD_DB_FILE = "fomod.db";
 
+// Journal size at which commitEntry() folds the journal back into the base file.
+constexpr uintmax_t FOMOD_DB_JOURNAL_COMPACT_THRESHOLD = 8 * 1024 * 1024;
+
 class FomodDB {
   public:
     /**
@@ -25,14 +33,271 @@ class FomodDB {
      * @param dbName The filename of the db. Only settable for testing purposes.
      */
     explicit FomodDB(const std::string& moBasePath, const std::string& dbName = FOMOD_DB_FILE)
+        : dbFilePath((std::filesystem::path(moBasePath) / dbName).string())
+        , journal(dbFilePath + ".journal")
     {
-        dbFilePath = (std::filesystem::path(moBasePath) / dbName).string();
         loadFromFile();
     }
 
-    // TODO: Also pull from non install steps (requiredInstallFiles or whatever, and optional);
+    FomodDB(const FomodDB&)            = delete;
+    FomodDB& operator=(const FomodDB&) = delete;
+
+    // Fold any outstanding journal records into the base file on shutdown.
+    ~FomodDB()
+    {
+        if (!journal.empty()) {
+            compact();
+        }
+    }
+
     static std::shared_ptr<FomodDbEntry> getEntryFromFomod(
         ModuleConfiguration* fomod, std::vector<QString> pluginPaths, int modId, MastersCache* cache = nullptr)
+    {
+        // A path on disk is one file, so it can key the cache as is
+        return buildEntryFromFomod(
+            fomod, pluginPaths, [](const QString& path) { return path; },
+            [](const QString& path) { return path.toStdString(); },
+            [](const QString& path) { return PluginReader::readHeader(path.toStdString(), true); }, modId, cache);
+    }
+
+    /**
+     * Same as above, for plugins extracted into memory (ArchiveExtractor::extractFomodDataToMemory). Plugins with an
+     * empty header were left in the archive because cache already has their header.
+     */
+    static std::shared_ptr<FomodDbEntry> getEntryFromFomod(ModuleConfiguration* fomod,
+        const std::vector<ExtractedPlugin>& plugins, int modId, MastersCache* cache = nullptr)
+    {
+        return buildEntryFromFomod(
+            fomod, plugins, [](const ExtractedPlugin& plugin) { return QString::fromStdString(plugin.archivePath); },
+            [](const ExtractedPlugin& plugin) {
+                return MastersCache::key(plugin.archivePath, plugin.size, plugin.crc);
+            },
+            [](const ExtractedPlugin& plugin) { return PluginReader::readHeaderFromBuffer(plugin.header, true); },
+            modId, cache);
+    }
+
+    /**
+     * Add an entry to the in-memory DB. With upsert, an existing entry for the same mod is replaced in place; mods are
+     * matched by modId, or by display name when modId is 0 (manual installs).
+     */
+    void addEntry(const std::shared_ptr<FomodDbEntry>& entry, const bool upsert = true)
+    {
+        if (upsert) {
+            if (const auto index = findIndex(entry->getModId(), entry->getDisplayName())) {
+                entries[*index] = entry;
+                return;
+            }
+        }
+        entries.emplace_back(entry);
+        indexEntry(entries.size() - 1);
+    }
+
+    /**
+     * @return The entry for the given Nexus mod ID, or nullptr. modId 0 is not a real ID; use findByName() instead.
+     */
+    [[nodiscard]] std::shared_ptr<FomodDbEntry> findByModId(const int modId) const
+    {
+        const auto it = modIdIndex.find(modId);
+        return it != modIdIndex.end() ? entries[it->second] : nullptr;
+    }
+
+    /**
+     * @return The modId 0 entry with the given display name, or nullptr.
+     */
+    [[nodiscard]] std::shared_ptr<FomodDbEntry> findByName(const std::string& displayName) const
+    {
+        const auto it = nameIndex.find(displayName);
+        return it != nameIndex.end() ? entries[it->second] : nullptr;
+    }
+
+    /**
+     * @return The entry for a mod, matched the way addEntry() matches them: by modId, or by display name when modId is
+     * 0. Any other modId, including MO2's -1 for an unknown ID, is matched by ID.
+     */
+    [[nodiscard]] std::shared_ptr<FomodDbEntry> find(const int modId, const std::string& displayName) const
+    {
+        return modId != 0 ? findByModId(modId) : findByName(displayName);
+    }
+
+    /**
+     * Upsert an entry and persist it by appending a journal record. This costs O(entry) I/O instead of rewriting
+     * the whole DB. The journal is compacted into the base file once it passes the configured threshold.
+     */
+    void commitEntry(const std::shared_ptr<FomodDbEntry>& entry)
+    {
+        addEntry(entry, true);
+        if (!journal.appendUpsert(entry)) {
+            std::cerr << "[FomodDB] Could not append to " << journal.getPath() << "; rewriting the DB instead"
+                      << std::endl;
+            commitEntries({ entry });
+            return;
+        }
+        if (journal.size() > journalCompactThreshold) {
+            compact();
+        } else {
+            loadedStamp = diskStamp();
+        }
+    }
+
+    /**
+     * Remove the entry matching the given mod (by modId, or by display name for modId 0) and journal the removal.
+     * @return true if an entry was removed.
+     */
+    bool removeEntry(const int modId, const std::string& displayName)
+    {
+        if (!eraseEntry(modId, displayName)) {
+            return false;
+        }
+        if (!journal.appendRemove(modId, displayName)) {
+            std::cerr << "[FomodDB] Could not append to " << journal.getPath() << "; rewriting the DB instead"
+                      << std::endl;
+            loadFromFile();
+            eraseEntry(modId, displayName);
+            saveToFile();
+            return true;
+        }
+        loadedStamp = diskStamp();
+        return true;
+    }
+
+    /**
+     * Upsert a batch of entries and rewrite the whole DB, for bulk updates such as a rescan. Like compact(), the DB is
+     * reloaded from disk first, so records other FomodDB instances journaled in the meantime are kept.
+     */
+    void commitEntries(const FOMODDBEntries& batch)
+    {
+        loadFromFile();
+        for (const auto& entry : batch) {
+            addEntry(entry, true);
+        }
+        saveToFile();
+    }
+
+    /**
+     * Fold the journal into the base file. The DB is first reloaded from disk (base + journal), so records appended
+     * by other FomodDB instances on the same file are kept. In-memory changes made with addEntry() that were never
+     * committed or saved are not part of the journal and are discarded.
+     */
+    void compact()
+    {
+        loadFromFile();
+        saveToFile();
+    }
+
+    void setJournalCompactThreshold(const uintmax_t bytes) { journalCompactThreshold = bytes; }
+
+    [[nodiscard]] const FomodDBJournal& getJournal() const { return journal; }
+
+    [[nodiscard]] const FOMODDBEntries& getEntries() { return entries; }
+
+    void reload() { loadFromFile(); }
+
+    /**
+     * @return true if another FomodDB instance (e.g. the installer's) wrote to the DB or its journal since this one
+     * last loaded or wrote it. Only stats the two files, so it is cheap enough to check before deciding to reload().
+     */
+    [[nodiscard]] bool changedOnDisk() const { return diskStamp() != loadedStamp; }
+
+    /**
+     * @return true if fomod.db exists but could not be read (corrupt, or written by a newer version). The next save
+     * moves it aside to fomod.db.bad instead of overwriting it.
+     */
+    [[nodiscard]] bool baseLoadFailed() const { return baseUnreadable; }
+
+    /**
+     * Write the whole DB to disk in the binary format (see FomodDBBinary.h) and clear the journal.
+     * The file is written to a temporary sibling and renamed over fomod.db, so a crash never leaves it truncated.
+     * An unreadable fomod.db is first moved to fomod.db.bad; if that fails, nothing is written.
+     */
+    void saveToFile() const
+    {
+        try {
+            if (baseUnreadable && !moveBaseFileAside()) {
+                return;
+            }
+
+            const auto tempFilePath = dbFilePath + ".tmp";
+            {
+                std::ofstream file(tempFilePath, std::ios::binary | std::ios::trunc);
+                if (!file.is_open()) {
+                    return;
+                }
+
+                const auto bytes = FomodDBBinary::serialize(entries);
+                file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+                if (!file.good()) {
+                    return;
+                }
+            }
+
+            std::error_code ec;
+            std::filesystem::rename(tempFilePath, dbFilePath, ec);
+            if (ec) {
+                std::filesystem::remove(tempFilePath, ec);
+                return;
+            }
+
+            // Everything in the journal is now part of the base file.
+            journal.clear();
+            loadedStamp = diskStamp();
+        } catch ([[maybe_unused]] const std::exception& e) {
+            // Handle saving errors
+        }
+    }
+
+    /**
+     * Export the DB as a pretty-printed JSON array (the pre-binary fomod.db format).
+     */
+    bool exportJson(const std::string& jsonFilePath) const
+    {
+        try {
+            std::ofstream file(jsonFilePath);
+            if (!file.is_open()) {
+                return false;
+            }
+            file << toJson().dump(2);
+            return true;
+        } catch ([[maybe_unused]] const std::exception& e) {
+            return false;
+        }
+    }
+
+    /**
+     * Replace the in-memory entries with the contents of a JSON export. Call saveToFile() to persist them.
+     */
+    bool importJson(const std::string& jsonFilePath)
+    {
+        try {
+            std::ifstream file(jsonFilePath);
+            if (!file.is_open()) {
+                return false;
+            }
+            return loadFromJson(nlohmann::json::parse(file));
+        } catch ([[maybe_unused]] const std::exception& e) {
+            return false;
+        }
+    }
+
+    [[nodiscard]] nlohmann::json toJson() const
+    {
+        nlohmann::json jsonArray = nlohmann::json::array();
+
+        for (const auto& entry : entries) {
+            jsonArray.push_back(entry->toJson());
+        }
+
+        return jsonArray;
+    }
+
+  private:
+    // Shared by both getEntryFromFomod() overloads. pathOf(plugin) gives the extracted plugin's path, which is
+    // matched against the FOMOD's file sources; keyOf(plugin) is its MastersCache key; readHeader(plugin) reads its
+    // header on a cache miss.
+    // TODO: Also pull from non install steps (requiredInstallFiles or whatever, and optional);
+    template <typename Plugin, typename PathOf, typename KeyOf, typename ReadHeader>
+    static std::shared_ptr<FomodDbEntry> buildEntryFromFomod(ModuleConfiguration* fomod,
+        const std::vector<Plugin>& plugins, PathOf&& pathOf, KeyOf&& keyOf, ReadHeader&& readHeader, int modId,
+        MastersCache* cache)
     {
         std::vector<FomodOption> options;
         for (const auto& installStep : fomod->installSteps.installSteps) {
@@ -42,7 +307,7 @@ class FomodDB {
                     // This allows searching/browsing all options, with master-matching for patches
 
                     std::string pluginFileName;
-                    std::vector<std::string> masters;
+                    PluginHeader header;
 
                     // Look for plugin files (.esp/.esm/.esl) to extract masters for patch matching
                     for (const auto& file : plugin.files.files) {
@@ -54,32 +319,21 @@ class FomodDB {
                         QString normalizedSource = QString::fromStdString(file.source).replace('\\', '/');
 
                         // Find the extracted path that ends with this file
-                        auto it = std::ranges::find_if(pluginPaths, [&normalizedSource](const QString& path) {
-                            QString normalizedPath = path;
+                        auto it = std::ranges::find_if(plugins, [&](const Plugin& extracted) {
+                            QString normalizedPath = pathOf(extracted);
                             normalizedPath.replace('\\', '/');
                             return normalizedPath.endsWith(normalizedSource);
                         });
-                        if (it == pluginPaths.end()) {
+                        if (it == plugins.end()) {
                             continue;
                         }
 
-                        // Found a plugin file - read its masters (using cache if available)
+                        // Found a plugin file - read its header and masters (using cache if available)
                         pluginFileName = file.source;
-                        const auto justFileName
-                            = QFileInfo(QString::fromStdString(file.source)).fileName().toStdString();
-
                         if (cache) {
-                            auto cacheIt = cache->find(justFileName);
-                            if (cacheIt != cache->end()) {
-                                // Cache hit - use cached masters
-                                masters = cacheIt->second;
-                            } else {
-                                // Cache miss - read and cache
-                                masters                = PluginReader::readMasters(it->toStdString(), true);
-                                (*cache)[justFileName] = masters;
-                            }
+                            header = cache->getOrRead(keyOf(*it), [&] { return readHeader(*it); });
                         } else {
-                            masters = PluginReader::readMasters(it->toStdString(), true);
+                            header = readHeader(*it);
                         }
                         break; // Use first plugin file found
                     }
@@ -88,105 +342,144 @@ class FomodDB {
                     auto typePatterns = extractTypePatterns(plugin);
 
                     // Always create an option entry, even if no plugin files
-                    options.emplace_back(plugin.name,
+                    auto& option = options.emplace_back(plugin.name,
                         pluginFileName, // May be empty if no plugin files
-                        masters, // May be empty if no plugin files
+                        toStringIds(header.masters), // May be empty if no plugin files
                         installStep.name, group.name, SelectionState::Unknown, std::move(typePatterns));
+                    option.pluginHeader = toStoredPluginHeader(header);
                 }
             }
         }
-        return std::make_shared<FomodDbEntry>(modId, fomod->moduleName, options);
+        return std::make_shared<FomodDbEntry>(modId, fomod->moduleName, std::move(options));
     }
 
-    void addEntry(const std::shared_ptr<FomodDbEntry>& entry, const bool upsert = true)
+    FOMODDBEntries entries;
+    std::string dbFilePath;
+    FomodDBJournal journal;
+    uintmax_t journalCompactThreshold = FOMOD_DB_JOURNAL_COMPACT_THRESHOLD;
+
+    // Size and modification time of the files on disk, as of the last load or write by this instance.
+    struct DiskStamp {
+        uintmax_t baseSize = 0;
+        std::filesystem::file_time_type baseTime {};
+        uintmax_t journalSize = 0;
+
+        bool operator==(const DiskStamp&) const = default;
+    };
+    mutable DiskStamp loadedStamp;
+
+    // fomod.db exists but loadBaseFile() couldn't read it, so `entries` is missing whatever it holds
+    mutable bool baseUnreadable = false;
+
+    [[nodiscard]] DiskStamp diskStamp() const
     {
-        // TODO: Test this upsert.
-        if (upsert) {
-            const auto it = std::ranges::find_if(entries,
-                [&entry](const std::shared_ptr<FomodDbEntry>& e) { return e->getModId() == entry->getModId(); });
-            if (it != entries.end()) {
-                *it = entry;
-            } else {
-                entries.emplace_back(entry);
-            }
-        } else {
-            entries.emplace_back(entry);
+        std::error_code ec;
+        DiskStamp stamp;
+        stamp.baseSize = std::filesystem::file_size(dbFilePath, ec);
+        if (ec) {
+            stamp.baseSize = 0;
         }
+        stamp.baseTime    = std::filesystem::last_write_time(dbFilePath, ec);
+        stamp.journalSize = journal.size();
+        return stamp;
     }
 
-    [[nodiscard]] const FOMODDBEntries& getEntries() { return entries; }
-
-    void reload() { loadFromFile(); }
+    // Secondary indexes into `entries`. Entries with a Nexus ID are keyed by modId, manual installs (modId 0) by
+    // display name. When non-upsert adds create duplicates, the first occurrence is indexed.
+    std::unordered_map<int, size_t> modIdIndex;
+    std::unordered_map<std::string, size_t> nameIndex;
 
-    void saveToFile() const
+    [[nodiscard]] std::optional<size_t> findIndex(const int modId, const std::string& displayName) const
     {
-        try {
-            std::ofstream file(dbFilePath);
-            if (!file.is_open()) {
-                return;
+        if (modId != 0) {
+            if (const auto it = modIdIndex.find(modId); it != modIdIndex.end()) {
+                return it->second;
             }
-
-            file << toJson().dump(2); // Pretty-print with 2-space indentation
-            file.close();
-        } catch ([[maybe_unused]] const std::exception& e) {
-            // Handle saving errors
+        } else if (const auto it = nameIndex.find(displayName); it != nameIndex.end()) {
+            return it->second;
         }
+        return std::nullopt;
     }
 
-    [[nodiscard]] nlohmann::json toJson() const
+    void indexEntry(const size_t index)
     {
-        nlohmann::json jsonArray = nlohmann::json::array();
+        const auto& entry = entries[index];
+        if (entry->getModId() != 0) {
+            modIdIndex.try_emplace(entry->getModId(), index);
+        } else {
+            nameIndex.try_emplace(entry->getDisplayName(), index);
+        }
+    }
 
-        for (const auto& entry : entries) {
-            jsonArray.push_back(entry->toJson());
+    void rebuildIndex()
+    {
+        modIdIndex.clear();
+        nameIndex.clear();
+        modIdIndex.reserve(entries.size());
+        for (size_t i = 0; i < entries.size(); ++i) {
+            indexEntry(i);
         }
+    }
 
-        return jsonArray;
+    bool eraseEntry(const int modId, const std::string& displayName)
+    {
+        const auto removed = std::erase_if(entries, [modId, &displayName](const std::shared_ptr<FomodDbEntry>& e) {
+            return modId != 0 ? e->getModId() == modId : e->getModId() == 0 && e->getDisplayName() == displayName;
+        });
+        if (removed > 0) {
+            rebuildIndex();
+        }
+        return removed > 0;
     }
 
-  private:
-    FOMODDBEntries entries;
-    std::string dbFilePath;
+    void replayJournal()
+    {
+        for (const auto& record : journal.readAll()) {
+            if (record.type == FomodDBJournal::RecordType::Upsert) {
+                addEntry(record.entry, true);
+            } else {
+                eraseEntry(record.modId, record.displayName);
+            }
+        }
+    }
 
-    static std::string pluginTypeToString(PluginTypeEnum type)
+    static StoredPluginType toStoredPluginType(const PluginTypeEnum type)
     {
         switch (type) {
         case PluginTypeEnum::Recommended:
-            return "Recommended";
+            return StoredPluginType::Recommended;
         case PluginTypeEnum::Required:
-            return "Required";
-        case PluginTypeEnum::Optional:
-            return "Optional";
+            return StoredPluginType::Required;
         case PluginTypeEnum::NotUsable:
-            return "NotUsable";
+            return StoredPluginType::NotUsable;
         case PluginTypeEnum::CouldBeUsable:
-            return "CouldBeUsable";
+            return StoredPluginType::CouldBeUsable;
+        case PluginTypeEnum::Optional:
         default:
-            return "Optional";
+            return StoredPluginType::Optional;
         }
     }
 
-    static std::string fileDependencyStateToString(FileDependencyTypeEnum state)
+    static StoredFileState toStoredFileState(const FileDependencyTypeEnum state)
     {
         switch (state) {
         case FileDependencyTypeEnum::Active:
-            return "Active";
+            return StoredFileState::Active;
         case FileDependencyTypeEnum::Inactive:
-            return "Inactive";
+            return StoredFileState::Inactive;
         case FileDependencyTypeEnum::Missing:
-            return "Missing";
         default:
-            return "Missing";
+            return StoredFileState::Missing;
         }
     }
 
     static StoredDependencies convertCompositeDependency(const CompositeDependency& cd)
     {
         StoredDependencies deps;
-        deps.operatorType = (cd.operatorType == OperatorTypeEnum::OR) ? "Or" : "And";
+        deps.operatorType = (cd.operatorType == OperatorTypeEnum::OR) ? StoredOperator::Or : StoredOperator::And;
 
         for (const auto& fd : cd.fileDependencies) {
-            deps.fileDependencies.push_back({ fd.file, fileDependencyStateToString(fd.state) });
+            deps.fileDependencies.push_back({ fd.file, toStoredFileState(fd.state) });
         }
 
         for (const auto& fd : cd.flagDependencies) {
@@ -200,6 +493,14 @@ class FomodDB {
         return deps;
     }
 
+    static StoredPluginHeader toStoredPluginHeader(const PluginHeader& header)
+    {
+        if (!header.valid) {
+            return {};
+        }
+        return { header.flags, header.recordCount, header.authorOffset, header.descriptionOffset, header.checksum };
+    }
+
     static std::vector<StoredTypePattern> extractTypePatterns(const Plugin& plugin)
     {
         std::vector<StoredTypePattern> patterns;
@@ -207,7 +508,7 @@ class FomodDB {
         // Extract dependency patterns from TypeDescriptor
         for (const auto& pattern : plugin.typeDescriptor.dependencyType.patterns.patterns) {
             StoredTypePattern stored;
-            stored.type         = pluginTypeToString(pattern.type);
+            stored.type         = toStoredPluginType(pattern.type);
             stored.dependencies = convertCompositeDependency(pattern.dependencies);
             patterns.push_back(std::move(stored));
         }
@@ -217,8 +518,8 @@ class FomodDB {
         if (patterns.empty() && plugin.typeDescriptor.type != PluginTypeEnum::Optional
             && plugin.typeDescriptor.type != PluginTypeEnum::UNKNOWN) {
             StoredTypePattern fallback;
-            fallback.type                 = pluginTypeToString(plugin.typeDescriptor.type);
-            fallback.dependencies.operatorType = "And";
+            fallback.type                 = toStoredPluginType(plugin.typeDescriptor.type);
+            fallback.dependencies.operatorType = StoredOperator::And;
             patterns.push_back(std::move(fallback));
         }
 
@@ -227,8 +528,8 @@ class FomodDB {
             auto defaultType = plugin.typeDescriptor.dependencyType.defaultType.value();
             if (defaultType != PluginTypeEnum::Optional && defaultType != PluginTypeEnum::UNKNOWN) {
                 StoredTypePattern fallback;
-                fallback.type                 = pluginTypeToString(defaultType);
-                fallback.dependencies.operatorType = "And";
+                fallback.type                 = toStoredPluginType(defaultType);
+                fallback.dependencies.operatorType = StoredOperator::And;
                 patterns.push_back(std::move(fallback));
             }
         }
@@ -239,35 +540,84 @@ class FomodDB {
     void loadFromFile()
     {
         entries.clear();
+        rebuildIndex();
+        baseUnreadable = false;
 
-        // Create empty file if it doesn't exist
-        if (!std::filesystem::exists(dbFilePath)) {
-            std::ofstream file(dbFilePath);
-            file << "[]"; // Empty JSON array
-            file.close();
+        // Create an empty DB if it doesn't exist
+        if (!std::filesystem::exists(dbFilePath) && journal.empty()) {
+            saveToFile();
             return; // No entries to load
         }
 
-        try {
-            // Read and parse the JSON file
-            std::ifstream file(dbFilePath);
-            if (!file.is_open()) {
-                return;
-            }
+        loadBaseFile();
+        rebuildIndex(); // The journal replays through addEntry(), which keeps the index current
+        replayJournal();
+        loadedStamp = diskStamp();
+    }
 
-            nlohmann::json jsonArray = nlohmann::json::parse(file);
+    void loadBaseFile()
+    {
+        if (!std::filesystem::exists(dbFilePath)) {
+            return;
+        }
+        QFile file(QString::fromStdString(dbFilePath));
+        if (!file.open(QIODevice::ReadOnly)) {
+            baseUnreadable = true;
+            return;
+        }
+        if (file.size() == 0) {
+            return;
+        }
 
-            // Ensure it's an array
-            if (!jsonArray.is_array()) {
-                return;
-            }
+        const auto size = file.size();
+        auto* mapped    = file.map(0, size);
+        if (mapped == nullptr) {
+            baseUnreadable = true;
+            return;
+        }
+        const std::span data(reinterpret_cast<const char*>(mapped), static_cast<size_t>(size));
 
-            // Process each entry in the array
-            for (const auto& entryJson : jsonArray) {
-                entries.push_back(std::make_unique<FomodDbEntry>(entryJson));
+        try {
+            if (FomodDBBinary::isBinary(data)) {
+                // Leaves entries empty on a corrupt or unknown-version file
+                baseUnreadable = !FomodDBBinary::deserialize(data, entries);
+            } else {
+                // Legacy JSON fomod.db. It is converted to the binary format on the next save.
+                baseUnreadable = !loadFromJson(nlohmann::json::parse(data.begin(), data.end()));
             }
         } catch ([[maybe_unused]] const std::exception& e) {
             // Handle parsing errors (leave entries empty)
+            entries.clear();
+            baseUnreadable = true;
+        }
+
+        file.unmap(mapped);
+    }
+
+    // Keep an unreadable fomod.db (e.g. from a newer version of the plugin) rather than overwrite it
+    bool moveBaseFileAside() const
+    {
+        std::error_code ec;
+        std::filesystem::rename(dbFilePath, dbFilePath + ".bad", ec);
+        if (ec && std::filesystem::exists(dbFilePath)) {
+            return false;
+        }
+        baseUnreadable = false;
+        return true;
+    }
+
+    bool loadFromJson(const nlohmann::json& jsonArray)
+    {
+        // Ensure it's an array
+        if (!jsonArray.is_array()) {
+            return false;
+        }
+
+        entries.clear();
+        for (const auto& entryJson : jsonArray) {
+            entries.push_back(std::make_shared<FomodDbEntry>(entryJson));
         }
+        rebuildIndex();
+        return true;
     }
 };
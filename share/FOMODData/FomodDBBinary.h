@@ -0,0 +1,436 @@
+#pragma once
+
+#include "BinaryIO.h"
+#include "FomodDBEntry.h"
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+Binary container for fomod.db. It is designed to be memory-mapped: a load validates the header, turns the string
+table into views over the mapping, and then walks the offset-indexed entry records. No text parsing is involved.
+
+    Header
+        char[4]  magic               "FMDB"
+        uint32   version             FomodDBBinary::VERSION
+        uint32   stringCount
+        uint32   entryCount
+        uint64   stringTableOffset
+        uint64   entryIndexOffset
+
+    String table (interned: step/group/master/file names are stored once)
+        uint32   offsets[stringCount + 1]    string i is blob[offsets[i], offsets[i + 1])
+        char     blob[]
+
+    Entry index
+        uint64   offsets[entryCount]         absolute offset of each entry record
+
+    Entry record
+        int32    modId
+        uint32   displayName                 (string id)
+        uint32   optionCount, Option[]
+
+    Option
+        uint32   name, fileName, step, group (string ids)
+        uint8    selectionState
+        uint32   masterCount, uint32 masters[] (string ids)
+        uint32   pluginFlags, recordCount, authorOffset, descriptionOffset, checksum    (StoredPluginHeader, v3+)
+        uint32   patternCount, { uint8 type (StoredPluginType), Dependencies }[]
+
+    Dependencies
+        uint8    operator                    (StoredOperator)
+        uint32   fileCount,   { uint32 file (string id), uint8 state (StoredFileState) }[]
+        uint32   flagCount,   { uint32 flag, uint32 value }[]
+        uint32   nestedCount, Dependencies[]
+
+Version 1 stored pattern type, operator and file state as string ids, and versions before 3 had no plugin header.
+They are still read so existing databases survive the upgrade; the next save writes the current version.
+
+The JSON representation (FomodDbEntry::toJson) remains the import/export format.
+*/
+
+class FomodDBBinary {
+  public:
+    static constexpr char MAGIC[4]        = { 'F', 'M', 'D', 'B' };
+    static constexpr uint32_t VERSION     = 3;
+    static constexpr uint32_t MIN_VERSION = 1; // Oldest version deserialize() still reads
+    static constexpr uint32_t MAX_NESTING = 64; // Guards against corrupt files recursing forever
+
+    using Entries = std::vector<std::shared_ptr<FomodDbEntry>>;
+
+    /**
+     * @return true if the data starts with the binary DB magic (as opposed to a legacy JSON array).
+     */
+    static bool isBinary(const std::span<const char> data)
+    {
+        return data.size() >= sizeof(MAGIC) && std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) == 0;
+    }
+
+    static std::vector<char> serialize(const Entries& entries)
+    {
+        StringTableBuilder strings;
+
+        // Encode entry records first so the string table is complete before it is written.
+        BinaryWriter records;
+        std::vector<uint64_t> recordOffsets;
+        recordOffsets.reserve(entries.size());
+        for (const auto& entry : entries) {
+            recordOffsets.push_back(records.size());
+            writeEntry(records, strings, *entry);
+        }
+
+        BinaryWriter out;
+        out.writeBytes({ MAGIC, sizeof(MAGIC) });
+        out.write<uint32_t>(VERSION);
+        out.write<uint32_t>(static_cast<uint32_t>(strings.size()));
+        out.write<uint32_t>(static_cast<uint32_t>(entries.size()));
+        const auto stringTableOffsetPos = out.size();
+        out.write<uint64_t>(0);
+        const auto entryIndexOffsetPos = out.size();
+        out.write<uint64_t>(0);
+
+        out.patch<uint64_t>(stringTableOffsetPos, out.size());
+        strings.writeTo(out);
+
+        out.patch<uint64_t>(entryIndexOffsetPos, out.size());
+        const uint64_t recordsBase = out.size() + recordOffsets.size() * sizeof(uint64_t);
+        for (const auto offset : recordOffsets) {
+            out.write<uint64_t>(recordsBase + offset);
+        }
+        out.writeBytes({ records.buffer().data(), records.size() });
+
+        return out.release();
+    }
+
+    /**
+     * Decode a binary DB. The span is only borrowed for the duration of the call.
+     * @return false if the header is invalid or any record is truncated/corrupt. `out` is left empty in that case.
+     */
+    static bool deserialize(const std::span<const char> data, Entries& out)
+    {
+        out.clear();
+        if (!isBinary(data)) {
+            return false;
+        }
+
+        BinaryReader header(data, sizeof(MAGIC));
+        const auto version           = header.read<uint32_t>();
+        const auto stringCount       = header.read<uint32_t>();
+        const auto entryCount        = header.read<uint32_t>();
+        const auto stringTableOffset = header.read<uint64_t>();
+        const auto entryIndexOffset  = header.read<uint64_t>();
+        if (header.failed() || version < MIN_VERSION || version > VERSION) {
+            return false;
+        }
+
+        // Pointer fixups: turn the string table into views over the mapped data.
+        Decoder decoder { version };
+        if (!readStringTable(data, stringTableOffset, stringCount, decoder.views)) {
+            return false;
+        }
+
+        BinaryReader index(data, entryIndexOffset);
+        if (!index.canRead(static_cast<size_t>(entryCount) * sizeof(uint64_t))) {
+            return false;
+        }
+
+        out.reserve(entryCount);
+        for (uint32_t i = 0; i < entryCount; ++i) {
+            BinaryReader record(data, index.read<uint64_t>());
+            auto entry = readEntry(record, decoder);
+            if (!entry) {
+                out.clear();
+                return false;
+            }
+            out.emplace_back(std::move(entry));
+        }
+        return true;
+    }
+
+  private:
+    // name, fileName, step, group, selectionState, masterCount, patternCount. Leaves out the v3 plugin header, so it
+    // is a lower bound for every version.
+    static constexpr size_t MIN_OPTION_SIZE = 4 * sizeof(uint32_t) + sizeof(uint8_t) + 2 * sizeof(uint32_t);
+    // operator, fileCount, flagCount, nestedCount
+    static constexpr size_t MIN_DEPENDENCIES_SIZE = sizeof(uint8_t) + 3 * sizeof(uint32_t);
+
+    // Per-file decoding state: the format version and the string table. Names stored as StringId are interned once
+    // per table, not once per reference.
+    struct Decoder {
+        uint32_t version;
+        std::vector<std::string_view> views;
+        std::vector<std::optional<StringId>> ids;
+
+        StringId id(const uint32_t index)
+        {
+            if (ids.empty()) {
+                ids.resize(views.size());
+            }
+            auto& cached = ids[index];
+            if (!cached) {
+                cached = StringId(views[index]);
+            }
+            return *cached;
+        }
+    };
+
+    class StringTableBuilder {
+      public:
+        uint32_t intern(const std::string_view str)
+        {
+            if (const auto it = mIds.find(str); it != mIds.end()) {
+                return it->second;
+            }
+            const auto id = static_cast<uint32_t>(mStrings.size());
+            mStrings.emplace_back(str);
+            mIds.emplace(mStrings.back(), id);
+            return id;
+        }
+
+        [[nodiscard]] size_t size() const { return mStrings.size(); }
+
+        void writeTo(BinaryWriter& out) const
+        {
+            uint32_t offset = 0;
+            for (const auto& str : mStrings) {
+                out.write<uint32_t>(offset);
+                offset += static_cast<uint32_t>(str.size());
+            }
+            out.write<uint32_t>(offset);
+            for (const auto& str : mStrings) {
+                out.writeBytes(str);
+            }
+        }
+
+      private:
+        // std::deque keeps element addresses stable, so the map can key on views into it.
+        std::deque<std::string> mStrings;
+        std::unordered_map<std::string_view, uint32_t> mIds;
+    };
+
+    static void writeDependencies(BinaryWriter& out, StringTableBuilder& strings, const StoredDependencies& deps)
+    {
+        out.write<uint8_t>(static_cast<uint8_t>(deps.operatorType));
+
+        out.write<uint32_t>(static_cast<uint32_t>(deps.fileDependencies.size()));
+        for (const auto& fd : deps.fileDependencies) {
+            out.write<uint32_t>(strings.intern(fd.file.str()));
+            out.write<uint8_t>(static_cast<uint8_t>(fd.state));
+        }
+
+        out.write<uint32_t>(static_cast<uint32_t>(deps.flagDependencies.size()));
+        for (const auto& fd : deps.flagDependencies) {
+            out.write<uint32_t>(strings.intern(fd.flag));
+            out.write<uint32_t>(strings.intern(fd.value));
+        }
+
+        out.write<uint32_t>(static_cast<uint32_t>(deps.nestedDependencies.size()));
+        for (const auto& nd : deps.nestedDependencies) {
+            writeDependencies(out, strings, nd);
+        }
+    }
+
+    static void writeEntry(BinaryWriter& out, StringTableBuilder& strings, const FomodDbEntry& entry)
+    {
+        out.write<int32_t>(entry.getModId());
+        out.write<uint32_t>(strings.intern(entry.getDisplayName()));
+        out.write<uint32_t>(static_cast<uint32_t>(entry.getOptions().size()));
+
+        for (const auto& option : entry.getOptions()) {
+            out.write<uint32_t>(strings.intern(option.name.str()));
+            out.write<uint32_t>(strings.intern(option.fileName.str()));
+            out.write<uint32_t>(strings.intern(option.step.str()));
+            out.write<uint32_t>(strings.intern(option.group.str()));
+            out.write<uint8_t>(static_cast<uint8_t>(option.selectionState));
+
+            out.write<uint32_t>(static_cast<uint32_t>(option.masters.size()));
+            for (const auto& master : option.masters) {
+                out.write<uint32_t>(strings.intern(master.str()));
+            }
+
+            out.write<uint32_t>(option.pluginHeader.flags);
+            out.write<uint32_t>(option.pluginHeader.recordCount);
+            out.write<uint32_t>(option.pluginHeader.authorOffset);
+            out.write<uint32_t>(option.pluginHeader.descriptionOffset);
+            out.write<uint32_t>(option.pluginHeader.checksum);
+
+            out.write<uint32_t>(static_cast<uint32_t>(option.typePatterns.size()));
+            for (const auto& pattern : option.typePatterns) {
+                out.write<uint8_t>(static_cast<uint8_t>(pattern.type));
+                writeDependencies(out, strings, pattern.dependencies);
+            }
+        }
+    }
+
+    static bool readStringTable(const std::span<const char> data, const uint64_t offset, const uint32_t count,
+        std::vector<std::string_view>& strings)
+    {
+        BinaryReader reader(data, offset);
+        if (!reader.canRead((static_cast<size_t>(count) + 1) * sizeof(uint32_t))) {
+            return false;
+        }
+
+        std::vector<uint32_t> offsets(count + 1);
+        for (auto& o : offsets) {
+            o = reader.read<uint32_t>();
+        }
+
+        const auto blob = reader.readBytes(offsets.back());
+        if (reader.failed()) {
+            return false;
+        }
+
+        strings.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            if (offsets[i] > offsets[i + 1]) {
+                return false;
+            }
+            strings.emplace_back(blob.substr(offsets[i], offsets[i + 1] - offsets[i]));
+        }
+        return true;
+    }
+
+    static SelectionState toSelectionState(const uint8_t raw)
+    {
+        return raw <= static_cast<uint8_t>(SelectionState::Available) ? static_cast<SelectionState>(raw)
+                                                                       : SelectionState::Unknown;
+    }
+
+    static std::optional<uint32_t> readStringIndex(BinaryReader& reader, const Decoder& decoder)
+    {
+        const auto index = reader.read<uint32_t>();
+        if (reader.failed() || index >= decoder.views.size()) {
+            // Poison the reader so the caller's failure check catches dangling ids too.
+            reader.fail();
+            return std::nullopt;
+        }
+        return index;
+    }
+
+    static std::string readString(BinaryReader& reader, const Decoder& decoder)
+    {
+        const auto index = readStringIndex(reader, decoder);
+        return index ? std::string(decoder.views[*index]) : std::string();
+    }
+
+    static StringId readStringId(BinaryReader& reader, Decoder& decoder)
+    {
+        const auto index = readStringIndex(reader, decoder);
+        return index ? decoder.id(*index) : StringId();
+    }
+
+    // Version 2+ stores enums as one byte; version 1 stored their names as string ids.
+    template <typename Enum>
+    static Enum readEnum(
+        BinaryReader& reader, const Decoder& decoder, Enum (*fromString)(std::string_view), const Enum last)
+    {
+        if (decoder.version == 1) {
+            return fromString(readString(reader, decoder));
+        }
+        const auto raw = reader.read<uint8_t>();
+        return raw <= static_cast<uint8_t>(last) ? static_cast<Enum>(raw) : fromString({});
+    }
+
+    // Counts are validated against the remaining bytes so a corrupt count can't trigger a huge allocation.
+    static uint32_t readCount(BinaryReader& reader, const size_t minElementSize)
+    {
+        const auto count = reader.read<uint32_t>();
+        if (static_cast<size_t>(count) * minElementSize > reader.remaining()) {
+            reader.fail();
+            return 0;
+        }
+        return count;
+    }
+
+    static bool readDependencies(
+        BinaryReader& reader, Decoder& decoder, StoredDependencies& deps, const uint32_t depth = 0)
+    {
+        if (depth > MAX_NESTING) {
+            return false;
+        }
+
+        deps.operatorType = readEnum(reader, decoder, stringToStoredOperator, StoredOperator::Or);
+
+        const auto fileCount = readCount(reader, sizeof(uint32_t) + sizeof(uint8_t));
+        deps.fileDependencies.reserve(fileCount);
+        for (uint32_t i = 0; i < fileCount; ++i) {
+            const auto file  = readStringId(reader, decoder);
+            const auto state = readEnum(reader, decoder, stringToStoredFileState, StoredFileState::Missing);
+            deps.fileDependencies.push_back({ file, state });
+        }
+
+        const auto flagCount = readCount(reader, 2 * sizeof(uint32_t));
+        deps.flagDependencies.reserve(flagCount);
+        for (uint32_t i = 0; i < flagCount; ++i) {
+            auto flag  = readString(reader, decoder);
+            auto value = readString(reader, decoder);
+            deps.flagDependencies.push_back({ std::move(flag), std::move(value) });
+        }
+
+        const auto nestedCount = readCount(reader, MIN_DEPENDENCIES_SIZE);
+        deps.nestedDependencies.resize(nestedCount);
+        for (auto& nested : deps.nestedDependencies) {
+            if (!readDependencies(reader, decoder, nested, depth + 1)) {
+                return false;
+            }
+        }
+        return !reader.failed();
+    }
+
+    static std::shared_ptr<FomodDbEntry> readEntry(BinaryReader& reader, Decoder& decoder)
+    {
+        const auto modId       = reader.read<int32_t>();
+        auto displayName       = readString(reader, decoder);
+        const auto optionCount = readCount(reader, MIN_OPTION_SIZE);
+
+        std::vector<FomodOption> options;
+        options.reserve(optionCount);
+        for (uint32_t i = 0; i < optionCount && !reader.failed(); ++i) {
+            const auto name     = readStringId(reader, decoder);
+            const auto fileName = readStringId(reader, decoder);
+            const auto step     = readStringId(reader, decoder);
+            const auto group    = readStringId(reader, decoder);
+            const auto state    = toSelectionState(reader.read<uint8_t>());
+
+            const auto masterCount = readCount(reader, sizeof(uint32_t));
+            std::vector<StringId> masters;
+            masters.reserve(masterCount);
+            for (uint32_t m = 0; m < masterCount; ++m) {
+                masters.push_back(readStringId(reader, decoder));
+            }
+
+            StoredPluginHeader pluginHeader;
+            if (decoder.version >= 3) {
+                pluginHeader.flags             = reader.read<uint32_t>();
+                pluginHeader.recordCount       = reader.read<uint32_t>();
+                pluginHeader.authorOffset      = reader.read<uint32_t>();
+                pluginHeader.descriptionOffset = reader.read<uint32_t>();
+                pluginHeader.checksum          = reader.read<uint32_t>();
+            }
+
+            const auto patternCount = readCount(reader, sizeof(uint8_t) + MIN_DEPENDENCIES_SIZE);
+            std::vector<StoredTypePattern> typePatterns(patternCount);
+            for (auto& pattern : typePatterns) {
+                pattern.type = readEnum(reader, decoder, stringToStoredPluginType, StoredPluginType::CouldBeUsable);
+                if (!readDependencies(reader, decoder, pattern.dependencies)) {
+                    return nullptr;
+                }
+            }
+
+            auto& option
+                = options.emplace_back(name, fileName, std::move(masters), step, group, state, std::move(typePatterns));
+            option.pluginHeader = pluginHeader;
+        }
+
+        if (reader.failed()) {
+            return nullptr;
+        }
+        return std::make_shared<FomodDbEntry>(modId, std::move(displayName), std::move(options));
+    }
+};
@@ -1,7 +1,11 @@
 #pragma once
 
+#include "StringPool.h"
+
 #include <nlohmann/json.hpp>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -25,6 +29,13 @@ in the FOMOD with their respective masters.
             "step": "Page One",
             "group": "Group One",
             "selectionState": "Available",
+            "pluginHeader": {
+                "flags": 0,
+                "recordCount": 3,
+                "authorOffset": 24,
+                "descriptionOffset": 0,
+                "checksum": 1234
+            },
             "typePatterns": [
                 {
                     "type": "Recommended",
@@ -79,10 +90,77 @@ inline SelectionState stringToSelectionState(const std::string& str)
     return SelectionState::Unknown;
 }
 
+// Condition values are stored as 1-byte enums and only converted to/from strings at the JSON boundary.
+
+enum class StoredFileState : uint8_t { Active, Inactive, Missing };
+
+enum class StoredOperator : uint8_t { And, Or };
+
+enum class StoredPluginType : uint8_t { Required, Optional, Recommended, NotUsable, CouldBeUsable };
+
+inline std::string storedFileStateToString(const StoredFileState state)
+{
+    switch (state) {
+    case StoredFileState::Active:
+        return "Active";
+    case StoredFileState::Inactive:
+        return "Inactive";
+    case StoredFileState::Missing:
+    default:
+        return "Missing";
+    }
+}
+
+inline StoredFileState stringToStoredFileState(const std::string_view str)
+{
+    if (str == "Active")
+        return StoredFileState::Active;
+    if (str == "Inactive")
+        return StoredFileState::Inactive;
+    return StoredFileState::Missing;
+}
+
+inline std::string storedOperatorToString(const StoredOperator op) { return op == StoredOperator::Or ? "Or" : "And"; }
+
+inline StoredOperator stringToStoredOperator(const std::string_view str)
+{
+    return str == "Or" ? StoredOperator::Or : StoredOperator::And;
+}
+
+inline std::string storedPluginTypeToString(const StoredPluginType type)
+{
+    switch (type) {
+    case StoredPluginType::Required:
+        return "Required";
+    case StoredPluginType::Recommended:
+        return "Recommended";
+    case StoredPluginType::NotUsable:
+        return "NotUsable";
+    case StoredPluginType::CouldBeUsable:
+        return "CouldBeUsable";
+    case StoredPluginType::Optional:
+    default:
+        return "Optional";
+    }
+}
+
+inline StoredPluginType stringToStoredPluginType(const std::string_view str)
+{
+    if (str == "Required")
+        return StoredPluginType::Required;
+    if (str == "Recommended")
+        return StoredPluginType::Recommended;
+    if (str == "NotUsable")
+        return StoredPluginType::NotUsable;
+    if (str == "CouldBeUsable")
+        return StoredPluginType::CouldBeUsable;
+    return StoredPluginType::Optional;
+}
+
 // Stored version of FileDependency (XML-independent, JSON-serializable)
 struct StoredFileDependency {
-    std::string file;
-    std::string state; // "Active", "Inactive", "Missing"
+    StringId file;
+    StoredFileState state = StoredFileState::Missing;
 };
 
 // Stored version of FlagDependency (for completeness; not evaluable in PatchFinder)
@@ -93,7 +171,7 @@ struct StoredFlagDependency {
 
 // Stored version of CompositeDependency (recursive AND/OR composition)
 struct StoredDependencies {
-    std::string operatorType; // "And", "Or"
+    StoredOperator operatorType = StoredOperator::And;
     std::vector<StoredFileDependency> fileDependencies;
     std::vector<StoredFlagDependency> flagDependencies;
     std::vector<StoredDependencies> nestedDependencies;
@@ -101,20 +179,129 @@ struct StoredDependencies {
 
 // One condition→type pattern from TypeDescriptor
 struct StoredTypePattern {
-    std::string type; // "Recommended", "Required", "Optional", "NotUsable", etc.
+    StoredPluginType type = StoredPluginType::Optional;
     StoredDependencies dependencies;
 };
 
+/**
+ * A StoredTypePattern compiled to a flat instruction array, so evaluation is a loop instead of a recursive walk.
+ *
+ * The program keeps a single boolean accumulator. A Test sets it from one file dependency. An AND block jumps to
+ * its end as soon as a child leaves the accumulator false, and an OR block does the same when it is true, so
+ * evaluation short-circuits and never allocates. Semantics match ConditionEvaluator::evaluateDependencies: flag
+ * dependencies are skipped, and a block with no file or nested dependencies evaluates to false.
+ */
+class ConditionProgram {
+  public:
+    enum class Op : uint8_t { Test, JumpIfFalse, JumpIfTrue, False };
+
+    struct Instruction {
+        Op op;
+        StoredFileState state; // Test only
+        uint32_t target; // Jumps only: index of the next instruction to run
+        StringId file; // Test only
+    };
+
+    static ConditionProgram compile(const StoredTypePattern& pattern)
+    {
+        ConditionProgram program;
+        program.mType      = pattern.type;
+        program.mEvaluable = !pattern.dependencies.fileDependencies.empty()
+            || !pattern.dependencies.nestedDependencies.empty();
+        if (program.mEvaluable) {
+            program.compileBlock(pattern.dependencies);
+        }
+        return program;
+    }
+
+    /**
+     * @param resolve Callable taking the file name (as StringId) and returning its StoredFileState.
+     */
+    template <typename Resolver> [[nodiscard]] bool evaluate(Resolver&& resolve) const
+    {
+        bool acc        = false;
+        const auto size = static_cast<uint32_t>(mCode.size());
+        for (uint32_t pc = 0; pc < size; ++pc) {
+            const auto& instruction = mCode[pc];
+            switch (instruction.op) {
+            case Op::Test:
+                acc = resolve(instruction.file) == instruction.state;
+                break;
+            case Op::JumpIfFalse:
+                if (!acc) {
+                    pc = instruction.target - 1;
+                }
+                break;
+            case Op::JumpIfTrue:
+                if (acc) {
+                    pc = instruction.target - 1;
+                }
+                break;
+            case Op::False:
+                acc = false;
+                break;
+            }
+        }
+        return acc;
+    }
+
+    [[nodiscard]] StoredPluginType getType() const { return mType; }
+
+    // False for static fallbacks and flag-only patterns, which can't be checked against the load order
+    [[nodiscard]] bool isEvaluable() const { return mEvaluable; }
+
+    [[nodiscard]] const std::vector<Instruction>& getCode() const { return mCode; }
+
+  private:
+    StoredPluginType mType = StoredPluginType::Optional;
+    bool mEvaluable        = false;
+    std::vector<Instruction> mCode;
+
+    void compileBlock(const StoredDependencies& deps)
+    {
+        const auto childCount = deps.fileDependencies.size() + deps.nestedDependencies.size();
+        if (childCount == 0) {
+            mCode.push_back({ Op::False, {}, 0, {} });
+            return;
+        }
+
+        const auto jump = deps.operatorType == StoredOperator::Or ? Op::JumpIfTrue : Op::JumpIfFalse;
+        std::vector<size_t> exits;
+        size_t remaining = childCount;
+
+        const auto afterChild = [&] {
+            if (--remaining > 0) {
+                exits.push_back(mCode.size());
+                mCode.push_back({ jump, {}, 0, {} });
+            }
+        };
+
+        for (const auto& fd : deps.fileDependencies) {
+            mCode.push_back({ Op::Test, fd.state, 0, fd.file });
+            afterChild();
+        }
+        for (const auto& nested : deps.nestedDependencies) {
+            compileBlock(nested);
+            afterChild();
+        }
+
+        // Short-circuit exits land after the last child, with the deciding child's result in the accumulator
+        for (const auto exit : exits) {
+            mCode[exit].target = static_cast<uint32_t>(mCode.size());
+        }
+    }
+};
+
 // --- JSON serialization helpers ---
 
 inline nlohmann::json storedDependenciesToJson(const StoredDependencies& deps)
 {
     nlohmann::json j;
-    j["operator"] = deps.operatorType;
+    j["operator"] = storedOperatorToString(deps.operatorType);
 
     nlohmann::json fileArr = nlohmann::json::array();
     for (const auto& fd : deps.fileDependencies) {
-        fileArr.push_back({ { "file", fd.file }, { "state", fd.state } });
+        fileArr.push_back({ { "file", fd.file }, { "state", storedFileStateToString(fd.state) } });
     }
     j["fileDependencies"] = fileArr;
 
@@ -140,11 +327,12 @@ inline nlohmann::json storedDependenciesToJson(const StoredDependencies& deps)
 inline StoredDependencies storedDependenciesFromJson(const nlohmann::json& j)
 {
     StoredDependencies deps;
-    deps.operatorType = j.value("operator", "And");
+    deps.operatorType = stringToStoredOperator(j.value("operator", "And"));
 
     if (j.contains("fileDependencies")) {
         for (const auto& fd : j["fileDependencies"]) {
-            deps.fileDependencies.push_back({ fd["file"], fd["state"] });
+            deps.fileDependencies.push_back(
+                { fd["file"].get<std::string>(), stringToStoredFileState(fd["state"].get<std::string>()) });
         }
     }
 
@@ -163,25 +351,76 @@ inline StoredDependencies storedDependenciesFromJson(const nlohmann::json& j)
     return deps;
 }
 
+/**
+ * Header metadata of an option's plugin, read once when the FOMOD is scanned so nothing needs to re-read the plugin.
+ * The masters live in FomodOption::masters. All zero (known() is false) if the option has no plugin or it wasn't read.
+ */
+struct StoredPluginHeader {
+    static constexpr uint32_t FLAG_MASTER = 0x00000001; // ESM
+    static constexpr uint32_t FLAG_LIGHT  = 0x00000200; // ESL
+
+    uint32_t flags             = 0; // TES4 record flags
+    uint32_t recordCount       = 0; // From HEDR
+    uint32_t authorOffset      = 0; // CNAM data offset in the TES4 record's subrecords; 0 if absent
+    uint32_t descriptionOffset = 0; // SNAM data offset, likewise
+    uint32_t checksum          = 0; // fnv1a32 of the TES4 record; identifies the plugin version
+
+    [[nodiscard]] bool known() const { return checksum != 0; }
+    [[nodiscard]] bool isMaster() const { return (flags & FLAG_MASTER) != 0; }
+    [[nodiscard]] bool isLight() const { return (flags & FLAG_LIGHT) != 0; }
+
+    bool operator==(const StoredPluginHeader&) const = default;
+};
+
+inline nlohmann::json storedPluginHeaderToJson(const StoredPluginHeader& header)
+{
+    return {
+        { "flags", header.flags },
+        { "recordCount", header.recordCount },
+        { "authorOffset", header.authorOffset },
+        { "descriptionOffset", header.descriptionOffset },
+        { "checksum", header.checksum },
+    };
+}
+
+inline StoredPluginHeader storedPluginHeaderFromJson(const nlohmann::json& json)
+{
+    StoredPluginHeader header;
+    header.flags             = json.value("flags", 0u);
+    header.recordCount       = json.value("recordCount", 0u);
+    header.authorOffset      = json.value("authorOffset", 0u);
+    header.descriptionOffset = json.value("descriptionOffset", 0u);
+    header.checksum          = json.value("checksum", 0u);
+    return header;
+}
+
+// Names are interned (see StringPool.h): the same masters and step/group names repeat across thousands of options.
 struct FomodOption {
-    std::string name;
-    std::string fileName;
-    std::vector<std::string> masters;
-    std::string step;
-    std::string group;
+    StringId name;
+    StringId fileName;
+    std::vector<StringId> masters;
+    StringId step;
+    StringId group;
     SelectionState selectionState = SelectionState::Unknown;
+    StoredPluginHeader pluginHeader;
     std::vector<StoredTypePattern> typePatterns;
+    // Compiled once from typePatterns (same order) when the option is created; see ConditionProgram.
+    std::vector<ConditionProgram> conditionPrograms;
 
-    FomodOption(std::string n, std::string fn, std::vector<std::string> m, std::string s, std::string g,
+    FomodOption(const StringId n, const StringId fn, std::vector<StringId> m, const StringId s, const StringId g,
         SelectionState state = SelectionState::Unknown, std::vector<StoredTypePattern> tp = {})
-        : name(std::move(n))
-        , fileName(std::move(fn))
+        : name(n)
+        , fileName(fn)
         , masters(std::move(m))
-        , step(std::move(s))
-        , group(std::move(g))
+        , step(s)
+        , group(g)
         , selectionState(state)
         , typePatterns(std::move(tp))
     {
+        conditionPrograms.reserve(typePatterns.size());
+        for (const auto& pattern : typePatterns) {
+            conditionPrograms.push_back(ConditionProgram::compile(pattern));
+        }
     }
 };
 
@@ -201,22 +440,26 @@ class FomodDbEntry {
             if (option.contains("typePatterns")) {
                 for (const auto& tp : option["typePatterns"]) {
                     StoredTypePattern pattern;
-                    pattern.type         = tp["type"];
+                    pattern.type         = stringToStoredPluginType(tp["type"].get<std::string>());
                     pattern.dependencies = storedDependenciesFromJson(tp["dependencies"]);
                     typePatterns.push_back(std::move(pattern));
                 }
             }
 
-            FomodOption fomodOption(option["name"], option["fileName"], option["masters"], option["step"],
-                option["group"], state, std::move(typePatterns));
+            FomodOption fomodOption(option["name"].get<std::string>(), option["fileName"].get<std::string>(),
+                option["masters"].get<std::vector<StringId>>(), option["step"].get<std::string>(),
+                option["group"].get<std::string>(), state, std::move(typePatterns));
+            if (option.contains("pluginHeader")) {
+                fomodOption.pluginHeader = storedPluginHeaderFromJson(option["pluginHeader"]);
+            }
             options.push_back(std::move(fomodOption));
         }
     }
 
-    explicit FomodDbEntry(const int modId, std::string displayName, const std::vector<FomodOption>& options)
+    explicit FomodDbEntry(const int modId, std::string displayName, std::vector<FomodOption> options)
         : modId(modId)
         , displayName(std::move(displayName))
-        , options(options)
+        , options(std::move(options))
     {
     }
 
@@ -240,12 +483,15 @@ class FomodDbEntry {
             optionJson["step"]           = option.step;
             optionJson["group"]          = option.group;
             optionJson["selectionState"] = selectionStateToString(option.selectionState);
+            if (option.pluginHeader.known()) {
+                optionJson["pluginHeader"] = storedPluginHeaderToJson(option.pluginHeader);
+            }
 
             if (!option.typePatterns.empty()) {
                 nlohmann::json patternsArr = nlohmann::json::array();
                 for (const auto& tp : option.typePatterns) {
                     patternsArr.push_back({
-                        { "type", tp.type },
+                        { "type", storedPluginTypeToString(tp.type) },
                         { "dependencies", storedDependenciesToJson(tp.dependencies) },
                     });
                 }
@@ -304,7 +550,7 @@ class FomodDbEntry {
         }
 
         for (auto& option : options) {
-            const auto key = option.step + "/" + option.group + "/" + option.name;
+            const auto key = option.step.str() + "/" + option.group.str() + "/" + option.name.str();
             if (auto it = stateMap.find(key); it != stateMap.end()) {
                 if (it->second.selected) {
                     option.selectionState = SelectionState::Selected;
@@ -0,0 +1,210 @@
+#pragma once
+
+#include "BinaryIO.h"
+#include "FomodDBBinary.h"
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+/*
+Append-only write-ahead journal that lives next to fomod.db (fomod.db.journal).
+
+Each install appends one small record instead of rewriting the whole DB. On load the journal is replayed on top of
+the base file, and FomodDB::compact() folds it back into the base once it grows too large.
+
+    File header
+        char[4]  magic      "FMDJ"
+        uint32   version    FomodDBJournal::VERSION
+
+    Record
+        uint8    type       RecordType
+        uint32   length     payload size in bytes
+        uint32   checksum   fnv1a32(payload)
+        byte     payload[length]
+
+    Upsert payload: a single-entry binary DB (FomodDBBinary::serialize), so it carries its own string table.
+    Remove payload: int32 modId, uint32 nameLength, char name[nameLength]
+
+A crash mid-append leaves a torn final record. Its length or checksum won't match, so replay stops there and every
+record before it is kept.
+*/
+
+class FomodDBJournal {
+  public:
+    static constexpr char MAGIC[4]    = { 'F', 'M', 'D', 'J' };
+    static constexpr uint32_t VERSION = 1;
+
+    enum class RecordType : uint8_t { Upsert = 1, Remove = 2 };
+
+    struct Record {
+        RecordType type;
+        std::shared_ptr<FomodDbEntry> entry; // Upsert only
+        int modId = 0; // Remove only
+        std::string displayName; // Remove only
+    };
+
+    explicit FomodDBJournal(std::string journalFilePath)
+        : path(std::move(journalFilePath))
+    {
+    }
+
+    bool appendUpsert(const std::shared_ptr<FomodDbEntry>& entry) const
+    {
+        const auto payload = FomodDBBinary::serialize({ entry });
+        return append(RecordType::Upsert, { payload.data(), payload.size() });
+    }
+
+    bool appendRemove(const int modId, const std::string& displayName) const
+    {
+        BinaryWriter payload;
+        payload.write<int32_t>(modId);
+        payload.write<uint32_t>(static_cast<uint32_t>(displayName.size()));
+        payload.writeBytes(displayName);
+        return append(RecordType::Remove, { payload.buffer().data(), payload.size() });
+    }
+
+    /**
+     * @return Every intact record in append order. Reading stops at the first torn or corrupt record, and that tail
+     * is cut off so records appended afterwards are replayable again.
+     */
+    [[nodiscard]] std::vector<Record> readAll() const
+    {
+        std::vector<Record> records;
+
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(path, ec)) {
+            return records;
+        }
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return records;
+        }
+        const std::vector<char> bytes((std::istreambuf_iterator(file)), std::istreambuf_iterator<char>());
+        file.close();
+
+        BinaryReader reader(bytes);
+        if (!hasValidHeader(reader)) {
+            return records;
+        }
+
+        size_t validLength = reader.offset();
+        while (reader.remaining() > 0) {
+            const auto type     = static_cast<RecordType>(reader.read<uint8_t>());
+            const auto length   = reader.read<uint32_t>();
+            const auto checksum = reader.read<uint32_t>();
+            const auto payload  = reader.readBytes(length);
+            if (reader.failed() || fnv1a32(payload) != checksum) {
+                break;
+            }
+
+            auto record = decode(type, payload);
+            if (!record) {
+                break;
+            }
+            records.push_back(std::move(*record));
+            validLength = reader.offset();
+        }
+
+        if (validLength < bytes.size()) {
+            std::filesystem::resize_file(path, validLength, ec);
+        }
+        return records;
+    }
+
+    [[nodiscard]] uintmax_t size() const
+    {
+        std::error_code ec;
+        const auto fileSize = std::filesystem::file_size(path, ec);
+        return ec ? 0 : fileSize;
+    }
+
+    [[nodiscard]] bool empty() const { return size() <= HEADER_SIZE; }
+
+    void clear() const
+    {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+
+    [[nodiscard]] const std::string& getPath() const { return path; }
+
+  private:
+    static constexpr size_t HEADER_SIZE = sizeof(MAGIC) + sizeof(uint32_t);
+
+    std::string path;
+
+    bool append(const RecordType type, const std::string_view payload) const
+    {
+        try {
+            const bool needsHeader = !hasValidHeaderOnDisk();
+
+            BinaryWriter record;
+            if (needsHeader) {
+                record.writeBytes({ MAGIC, sizeof(MAGIC) });
+                record.write<uint32_t>(VERSION);
+            }
+            record.write<uint8_t>(static_cast<uint8_t>(type));
+            record.write<uint32_t>(static_cast<uint32_t>(payload.size()));
+            record.write<uint32_t>(fnv1a32(payload));
+            record.writeBytes(payload);
+
+            // A missing, partial or foreign-version header means nothing in the file can be replayed; start over.
+            std::ofstream file(path, std::ios::binary | (needsHeader ? std::ios::trunc : std::ios::app));
+            if (!file.is_open()) {
+                return false;
+            }
+            file.write(record.buffer().data(), static_cast<std::streamsize>(record.size()));
+            file.flush();
+            return file.good();
+        } catch ([[maybe_unused]] const std::exception& e) {
+            return false;
+        }
+    }
+
+    [[nodiscard]] bool hasValidHeaderOnDisk() const
+    {
+        std::ifstream file(path, std::ios::binary);
+        char header[HEADER_SIZE];
+        if (!file.is_open() || !file.read(header, HEADER_SIZE)) {
+            return false;
+        }
+        BinaryReader reader(std::span<const char>(header, HEADER_SIZE));
+        return hasValidHeader(reader);
+    }
+
+    static bool hasValidHeader(BinaryReader& reader)
+    {
+        const auto magic   = reader.readBytes(sizeof(MAGIC));
+        const auto version = reader.read<uint32_t>();
+        return !reader.failed() && magic == std::string_view(MAGIC, sizeof(MAGIC)) && version == VERSION;
+    }
+
+    static std::optional<Record> decode(const RecordType type, const std::string_view payload)
+    {
+        switch (type) {
+        case RecordType::Upsert: {
+            FomodDBBinary::Entries entries;
+            if (!FomodDBBinary::deserialize(payload, entries) || entries.size() != 1) {
+                return std::nullopt;
+            }
+            return Record { RecordType::Upsert, std::move(entries.front()) };
+        }
+        case RecordType::Remove: {
+            BinaryReader reader(payload);
+            const auto modId      = reader.read<int32_t>();
+            const auto nameLength = reader.read<uint32_t>();
+            const auto name       = reader.readBytes(nameLength);
+            if (reader.failed()) {
+                return std::nullopt;
+            }
+            return Record { RecordType::Remove, nullptr, modId, std::string(name) };
+        }
+        default:
+            return std::nullopt;
+        }
+    }
+};
@@ -1,43 +1,77 @@
 #pragma once
 
 #include "ArchiveExtractor.h"
+#include "ArchiveMetadataCache.h"
+#include "ExtractionScratch.h"
 #include "FomodDB.h"
+#include "ModuleConfigCache.h"
 #include "stringutil.h"
 #include "xml/ModuleConfiguration.h"
 
 #include <QDir>
 #include <QString>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <imodinterface.h>
 #include <imoinfo.h>
+#include <mutex>
 #include <nlohmann/json.hpp>
+#include <optional>
+#include <semaphore>
+#include <thread>
 
 struct RescanResult {
     int totalModsProcessed  = 0;
     int successfullyScanned = 0;
-    int skippedNoOptions    = 0; // FOMODs with no installSteps/options
+    int skippedNoOptions    = 0; // FOMODs with no installSteps/options to track
     int missingArchives     = 0;
     int parseErrors         = 0;
     std::vector<std::string> failedMods; // Only actual failures, not skipped mods
+    ExtractionScratch::Stats scratch;    // Summed over the workers' scratch directories
+};
+
+struct RescanOptions {
+    // Workers running the extract -> parse -> masters stages. 0 uses one per hardware thread.
+    unsigned workers = 0;
+    // Archives extracted at the same time across all workers. Extraction is mostly disk-bound, so a couple is enough
+    // to keep the parse and masters stages of the other workers busy.
+    unsigned maxConcurrentExtractions = 2;
+    // Optional; the most bytes one archive may extract into a worker's scratch directory. Archives over it fail.
+    std::optional<uint64_t> scratchSizeCap;
 };
 
 /**
  * Orchestrates rescanning of all mods with stored FOMOD choices to repopulate the database.
  * Used when fomod.db is missing or needs to be regenerated from existing installations.
+ *
+ * Archives are processed by a bounded pool of workers (extract, parse ModuleConfig.xml, read masters). Everything
+ * that talks to MO2 or the DB stays on the calling thread: mod data is gathered up front, and results are merged into
+ * the DB in mod list order, with progress reported from there.
  */
 class FomodRescan {
   public:
     using ProgressCallback = std::function<void(int current, int total, const QString& modName)>;
 
-    FomodRescan(MOBase::IOrganizer* organizer, FomodDB* db)
+    FomodRescan(MOBase::IOrganizer* organizer, FomodDB* db, const RescanOptions& options = {})
         : mOrganizer(organizer)
         , mFomodDb(db)
+        , mOptions(options)
     {
     }
 
+    /**
+     * Stop handing out archives to the workers. Archives already being processed finish and are merged, so the DB
+     * keeps every mod scanned so far. Safe to call from the progress callback.
+     */
+    void cancel() { mCancelled = true; }
+
     /**
      * Scan all mods that have stored FOMOD Plus choices and repopulate the database.
-     * @param progressCallback Optional callback for progress updates
+     * @param progressCallback Optional callback for progress updates. Always called on the calling thread, also
+     * periodically while waiting on the workers, so a UI can keep processing events.
      * @return RescanResult with statistics about the scan
      */
     RescanResult scanAllModsWithChoices(const ProgressCallback& progressCallback = nullptr)
@@ -49,53 +83,106 @@ class FomodRescan {
             return result;
         }
 
-        // First pass: gather all mods with stored choices
-        std::vector<MOBase::IModInterface*> modsWithChoices;
+        // First pass: gather everything the workers need from MO2, which is only safe to call from this thread
+        std::vector<ScanJob> jobs;
+        const auto downloadsPath = mOrganizer->downloadsPath();
         for (const auto& modName : modList->allMods()) {
             auto* mod = modList->getMod(modName);
             if (mod && hasStoredChoices(mod)) {
-                modsWithChoices.push_back(mod);
+                jobs.push_back(makeJob(mod, downloadsPath));
             }
         }
 
-        result.totalModsProcessed = static_cast<int>(modsWithChoices.size());
+        result.totalModsProcessed = static_cast<int>(jobs.size());
 
         // Masters cache - avoids re-reading the same plugin files (e.g., Lux.esp) across archives
         MastersCache mastersCache;
 
-        // Second pass: process each mod
-        int current = 0;
-        for (auto* mod : modsWithChoices) {
-            current++;
-            if (progressCallback) {
-                progressCallback(current, result.totalModsProcessed, mod->name());
+        // Archives parsed by an earlier rescan and unchanged since are taken from here instead of being extracted
+        ArchiveMetadataCache archiveCache(QDir(mOrganizer->basePath()).filePath(ARCHIVE_CACHE_FILE).toStdString());
+
+        // Archives that changed but kept their ModuleConfig.xml, or were installed since, skip the XML parse
+        ModuleConfigCache moduleConfigCache(
+            QDir(mOrganizer->basePath()).filePath(MODULE_CONFIG_CACHE_DIR).toStdWString());
+
+        // Second pass: process the archives on the workers
+        ScanQueue queue(jobs.size());
+        std::counting_semaphore<> extractionSlots(std::max(1u, mOptions.maxConcurrentExtractions));
+        std::mutex scratchStatsMutex;
+        const auto worker = [&] {
+            // One directory per worker, reused for every archive it extracts
+            ExtractionScratch scratch(mOptions.scratchSizeCap);
+            for (size_t i = queue.next++; i < jobs.size(); i = queue.next++) {
+                if (mCancelled) {
+                    queue.complete(i, { ScanOutcome::Cancelled });
+                    continue;
+                }
+                try {
+                    queue.complete(i,
+                        processJob(jobs[i], mastersCache, archiveCache, moduleConfigCache, extractionSlots, scratch));
+                } catch (const std::exception& e) {
+                    queue.complete(i, { ScanOutcome::ParseError, std::string("exception: ") + e.what() });
+                } catch (...) {
+                    queue.complete(i, { ScanOutcome::ParseError, "unknown exception" });
+                }
             }
+            std::lock_guard lock(scratchStatsMutex);
+            result.scratch += scratch.stats();
+        };
+
+        std::vector<std::jthread> workers;
+        const auto workerCount = std::min<size_t>(resolveWorkerCount(), jobs.size());
+        workers.reserve(workerCount);
+        for (size_t i = 0; i < workerCount; ++i) {
+            workers.emplace_back(worker);
+        }
 
-            const auto [outcome, errorDetail] = processMod(mod, mastersCache);
-            switch (outcome) {
+        // Third pass: merge results in mod list order
+        FOMODDBEntries scannedEntries;
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            const auto& job = jobs[i];
+            const auto jobResult
+                = queue.await(i, [&] { reportProgress(progressCallback, i, result.totalModsProcessed, job); });
+            reportProgress(progressCallback, i + 1, result.totalModsProcessed, job);
+
+            const auto modName = job.modName.toStdString();
+            switch (jobResult.outcome) {
             case ScanOutcome::Success:
+                scannedEntries.push_back(jobResult.entry);
                 result.successfullyScanned++;
                 break;
             case ScanOutcome::MissingArchive:
                 result.missingArchives++;
-                result.failedMods.push_back(mod->name().toStdString() + " (missing archive)");
+                result.failedMods.push_back(modName + " (missing archive)");
                 break;
             case ScanOutcome::ParseError:
                 result.parseErrors++;
-                result.failedMods.push_back(mod->name().toStdString() + " (parse error: " + errorDetail + ")");
+                result.failedMods.push_back(modName + " (parse error: " + jobResult.errorDetail + ")");
                 break;
             case ScanOutcome::NoOptions:
                 // Not a failure - FOMOD has no installSteps/options to track
                 result.skippedNoOptions++;
                 break;
+            case ScanOutcome::Cancelled:
+                break;
             }
         }
+        workers.clear(); // Joins; every job is complete at this point
 
-        // Save the database
-        mFomodDb->saveToFile();
+        // Upsert into the database. This reloads it first, so installs journaled by the installer's FomodDB while
+        // the scan ran are kept.
+        mFomodDb->commitEntries(scannedEntries);
+        archiveCache.save();
+        moduleConfigCache.trim();
 
         // Log cache effectiveness
-        std::cout << "[FomodRescan] Masters cache: " << mastersCache.size() << " unique plugins cached" << std::endl;
+        std::cout << "[FomodRescan] Masters cache: " << mastersCache.size() << " unique plugins cached, "
+                  << archiveCache.size() << " archives cached, " << workerCount << " workers" << std::endl;
+        std::cout << "[FomodRescan] Scratch: " << result.scratch.extractions << " extractions, "
+                  << result.scratch.bytesWritten << " bytes written, " << result.scratch.bytesReclaimed
+                  << " bytes reclaimed, peak " << result.scratch.peakBytes << " bytes" << std::endl;
+        std::cout << "[FomodRescan] ModuleConfig cache: " << moduleConfigCache.hits() << " hits, "
+                  << moduleConfigCache.misses() << " misses" << std::endl;
 
         return result;
     }
@@ -103,14 +190,86 @@ class FomodRescan {
   private:
     MOBase::IOrganizer* mOrganizer;
     FomodDB* mFomodDb;
+    RescanOptions mOptions;
+    std::atomic<bool> mCancelled { false };
+
+    // How often the calling thread wakes up to report progress while waiting on the workers.
+    static constexpr auto PROGRESS_INTERVAL = std::chrono::milliseconds(50);
 
     enum class ScanOutcome {
         Success,
         MissingArchive,
         ParseError,
-        NoOptions // FOMOD exists but has no installSteps/options to track
+        NoOptions, // FOMOD exists but has no installSteps/options to track
+        Cancelled  // Never started because the scan was cancelled
+    };
+
+    // Everything a worker needs about one mod, copied out of MO2 on the calling thread.
+    struct ScanJob {
+        QString modName;
+        QString archivePath; // Empty if the archive is missing
+        int modId = 0;
+        nlohmann::json choices;
+    };
+
+    struct JobResult {
+        ScanOutcome outcome = ScanOutcome::Cancelled;
+        std::string errorDetail;
+        std::shared_ptr<FomodDbEntry> entry;
     };
 
+    // Completed results, handed from the workers to the merging thread by index.
+    class ScanQueue {
+      public:
+        explicit ScanQueue(const size_t size)
+            : mResults(size)
+        {
+        }
+
+        std::atomic<size_t> next { 0 };
+
+        void complete(const size_t index, JobResult result)
+        {
+            {
+                std::lock_guard lock(mMutex);
+                mResults[index] = std::move(result);
+            }
+            mReady.notify_all();
+        }
+
+        template <typename OnWait> JobResult await(const size_t index, OnWait&& onWait)
+        {
+            std::unique_lock lock(mMutex);
+            while (!mReady.wait_for(lock, PROGRESS_INTERVAL, [&] { return mResults[index].has_value(); })) {
+                lock.unlock();
+                onWait();
+                lock.lock();
+            }
+            return std::move(*mResults[index]);
+        }
+
+      private:
+        std::mutex mMutex;
+        std::condition_variable mReady;
+        std::vector<std::optional<JobResult>> mResults;
+    };
+
+    [[nodiscard]] size_t resolveWorkerCount() const
+    {
+        if (mOptions.workers > 0) {
+            return mOptions.workers;
+        }
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    static void reportProgress(
+        const ProgressCallback& progressCallback, const size_t current, const int total, const ScanJob& job)
+    {
+        if (progressCallback) {
+            progressCallback(static_cast<int>(current), total, job.modName);
+        }
+    }
+
     /**
      * Check if a mod has stored FOMOD Plus choices (non-zero pluginSetting).
      */
@@ -145,38 +304,64 @@ class FomodRescan {
         }
     }
 
-    using ProcessResult = std::pair<ScanOutcome, std::string>;
-
-    /**
-     * Process a single mod: extract archive, parse FOMOD, create DB entry with selection states.
-     * Returns outcome and optional error detail string.
-     */
-    ProcessResult processMod(MOBase::IModInterface* mod, MastersCache& cache)
+    ScanJob makeJob(MOBase::IModInterface* mod, const QString& downloadsPath) const
     {
+        ScanJob job;
+        job.modName = mod->name();
+        job.modId   = mod->nexusId();
+        job.choices = getStoredChoices(mod);
+
         // Get the archive path
         const auto installationFile = mod->installationFile();
-        if (installationFile.isEmpty()) {
-            return { ScanOutcome::MissingArchive, "" };
+        if (!installationFile.isEmpty()) {
+            const auto archivePath
+                = QDir(installationFile).isAbsolute() ? installationFile : downloadsPath + "/" + installationFile;
+            if (QFile::exists(archivePath)) {
+                job.archivePath = archivePath;
+            }
         }
+        return job;
+    }
 
-        const auto downloadsPath = mOrganizer->downloadsPath();
-        const auto archivePath
-            = QDir(installationFile).isAbsolute() ? installationFile : downloadsPath + "/" + installationFile;
+    /**
+     * Process a single mod on a worker: extract archive, parse FOMOD, create DB entry with selection states.
+     * Returns outcome, optional error detail string, and the entry to merge on success.
+     */
+    static JobResult processJob(const ScanJob& job, MastersCache& cache, ArchiveMetadataCache& archiveCache,
+        ModuleConfigCache& moduleConfigCache, std::counting_semaphore<>& extractionSlots, ExtractionScratch& scratch)
+    {
+        if (job.archivePath.isEmpty()) {
+            return { ScanOutcome::MissingArchive };
+        }
 
-        if (!QFile::exists(archivePath)) {
-            return { ScanOutcome::MissingArchive, "" };
+        if (const auto cached = archiveCache.find(job.archivePath); cached && cached->parsed) {
+            return fromCachedEntry(job, cached->entry);
         }
 
-        // Extract FOMOD data from archive
-        auto extractionResult = ArchiveExtractor::extractFomodData(archivePath);
+        // Extract FOMOD data from archive into memory; nothing below touches the disk. Plugins another archive already
+        // shipped (same name, size and CRC) stay compressed, which skips most of the work for big shared masters.
+        const auto needsHeader = [&cache](const ExtractedPlugin& plugin) {
+            return !cache.contains(MastersCache::key(plugin.archivePath, plugin.size, plugin.crc));
+        };
+        InMemoryExtractionResult extractionResult;
+        extractionSlots.acquire();
+        try {
+            extractionResult = ArchiveExtractor::extractFomodDataToMemory(job.archivePath, needsHeader, &scratch);
+        } catch (...) {
+            extractionSlots.release();
+            throw;
+        }
+        extractionSlots.release();
         if (!extractionResult.success) {
             return { ScanOutcome::ParseError, "extraction: " + extractionResult.errorMessage.toStdString() };
         }
 
-        // Parse ModuleConfiguration
-        auto moduleConfig = std::make_unique<ModuleConfiguration>();
+        // Parse ModuleConfiguration; the DB entry only needs names, type descriptors and file sources
+        std::unique_ptr<ModuleConfiguration> moduleConfig;
         try {
-            if (!moduleConfig->deserialize(extractionResult.moduleConfigPath)) {
+            const std::span<const char> xml(extractionResult.moduleConfig);
+            moduleConfig = moduleConfigCache.parse(xml, ParseProfile::IndexOnly);
+            if (!moduleConfig) {
                 return { ScanOutcome::ParseError, "XML deserialization failed" };
             }
         } catch (const std::exception& e) {
@@ -185,25 +370,33 @@ class FomodRescan {
             return { ScanOutcome::ParseError, "unknown XML exception" };
         }
 
-        // Get the mod's Nexus ID
-        const int modId = mod->nexusId();
-
         // Create FomodDbEntry using existing logic (with masters cache for performance)
-        auto entry = FomodDB::getEntryFromFomod(moduleConfig.get(), extractionResult.pluginPaths, modId, &cache);
+        auto entry = FomodDB::getEntryFromFomod(moduleConfig.get(), extractionResult.plugins, job.modId, &cache);
 
         if (!entry || entry->getOptions().empty()) {
             // Not a failure - FOMOD exists but has no installSteps/options to track
-            return { ScanOutcome::NoOptions, "" };
+            archiveCache.storeParsed(job.archivePath, nullptr);
+            return { ScanOutcome::NoOptions };
         }
+        archiveCache.storeParsed(job.archivePath, entry);
 
         // Apply selection states from stored choices
-        const auto choices = getStoredChoices(mod);
-        entry->applySelections(choices);
+        entry->applySelections(job.choices);
 
-        // Add to database (upsert)
-        mFomodDb->addEntry(entry, true);
-
-        return { ScanOutcome::Success, "" };
+        return { ScanOutcome::Success, "", std::move(entry) };
     }
 
+    /**
+     * Build the job's entry from an archive parsed by an earlier rescan. Its plugins' headers aren't added to the
+     * masters cache: the entry doesn't record the sizes and CRCs that key it.
+     */
+    static JobResult fromCachedEntry(const ScanJob& job, const std::shared_ptr<FomodDbEntry>& cached)
+    {
+        if (!cached) {
+            return { ScanOutcome::NoOptions };
+        }
+        auto entry = std::make_shared<FomodDbEntry>(job.modId, cached->getDisplayName(), cached->getOptions());
+        entry->applySelections(job.choices);
+        return { ScanOutcome::Success, "", std::move(entry) };
+    }
 };
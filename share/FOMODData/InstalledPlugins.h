@@ -0,0 +1,125 @@
+#pragma once
+
+#include "PluginStateSnapshot.h"
+#include "StringPool.h"
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+/*
+The Patch Finder's view of the user's setup: which mod provides which plugin, and the load order state of every plugin
+and condition file.
+
+Mod and plugin names are interned so matching them against masters and condition files from the DB is a pointer
+compare. Mods are keyed by name, since MO2 only reports the name of a removed mod.
+
+Ownership and load order are kept separately because they change separately: a plugin can stay active while the mod
+providing it is reinstalled, and can still be in the load order (from the Data folder or another mod) after the mod
+providing it is removed. So adding or removing a mod asks the plugin list for the current state of each of its plugins
+rather than deriving it.
+
+Every update appends the files whose ownership or state actually changed to changedFiles, so callers can re-evaluate
+only what depends on them.
+*/
+
+class InstalledPlugins {
+  public:
+    // The plugin list's current state of a plugin
+    using LoadOrderState = std::function<StoredFileState(StringId plugin)>;
+
+    /**
+     * Record the plugins a mod provides. A mod that was already recorded keeps its earlier plugins too; remove it first
+     * to replace them.
+     */
+    void addMod(const StringId modName, const std::vector<StringId>& plugins, const LoadOrderState& loadOrder,
+        std::vector<StringId>& changedFiles)
+    {
+        if (plugins.empty()) {
+            return;
+        }
+        auto& modPlugins = mModPlugins[modName];
+        for (const auto plugin : plugins) {
+            modPlugins.push_back(plugin);
+            auto& owners      = mOwners[plugin];
+            const bool gained = owners.empty();
+            owners.push_back(modName);
+            if (!setState(plugin, loadOrder(plugin), changedFiles) && gained) {
+                changedFiles.push_back(plugin);
+            }
+        }
+    }
+
+    void removeMod(const StringId modName, const LoadOrderState& loadOrder, std::vector<StringId>& changedFiles)
+    {
+        const auto it = mModPlugins.find(modName);
+        if (it == mModPlugins.end()) {
+            return;
+        }
+        for (const auto plugin : it->second) {
+            const auto owners = mOwners.find(plugin);
+            if (owners == mOwners.end()) {
+                continue;
+            }
+            std::erase(owners->second, modName);
+            const bool lost = owners->second.empty();
+            if (lost) {
+                mOwners.erase(owners);
+            }
+            if (!setState(plugin, loadOrder(plugin), changedFiles) && lost) {
+                changedFiles.push_back(plugin);
+            }
+        }
+        mModPlugins.erase(it);
+    }
+
+    /**
+     * Record the load order state of a plugin or condition file.
+     * @return true if it changed, in which case file was appended to changedFiles.
+     */
+    bool setState(const StringId file, const StoredFileState state, std::vector<StringId>& changedFiles)
+    {
+        if (mStates.state(file) == state) {
+            return false;
+        }
+        mStates.set(file.str(), state);
+        changedFiles.push_back(file);
+        return true;
+    }
+
+    /**
+     * @return The plugins modName provides, or nullptr if it provides none.
+     */
+    [[nodiscard]] const std::vector<StringId>* pluginsOf(const StringId modName) const
+    {
+        const auto it = mModPlugins.find(modName);
+        return it != mModPlugins.end() ? &it->second : nullptr;
+    }
+
+    /**
+     * @return The mods providing plugin, or nullptr if no mod does.
+     */
+    [[nodiscard]] const std::vector<StringId>* ownersOf(const StringId plugin) const
+    {
+        const auto it = mOwners.find(plugin);
+        return it != mOwners.end() ? &it->second : nullptr;
+    }
+
+    // A plugin is installed while any mod provides it
+    [[nodiscard]] bool isInstalled(const StringId plugin) const { return mOwners.contains(plugin); }
+
+    [[nodiscard]] const PluginStateSnapshot& states() const { return mStates; }
+
+    void clear()
+    {
+        mModPlugins.clear();
+        mOwners.clear();
+        mStates.clear();
+    }
+
+  private:
+    std::unordered_map<StringId, std::vector<StringId>> mModPlugins; // { modName: [1.esp, 2.esp, 3.esp] }
+    std::unordered_map<StringId, std::vector<StringId>> mOwners;     // { 1.esp: [modName, ...] }
+    PluginStateSnapshot mStates;
+};
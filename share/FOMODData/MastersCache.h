@@ -0,0 +1,74 @@
+#pragma once
+
+#include "PluginReader.h"
+
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+Plugin -> header (masters, flags, checksum), shared across all archives of a rescan so a plugin that ships in many
+FOMODs (e.g. Lux.esp) is only read once. Safe to use from several rescan workers at once.
+
+Plugins are keyed by file name, size and CRC (see key()), which the archive lists without decompressing anything. The
+file name alone isn't enough: unrelated FOMODs ship different plugins under the same name (e.g. "Patch.esp"), and the
+Patch Finder takes the header's checksum as the plugin's identity.
+*/
+
+class MastersCache {
+  public:
+    /**
+     * @return The cache key of the plugin at path (in its archive, '/' or '\\' separated) with this size and CRC.
+     */
+    static std::string key(const std::string_view path, const uint64_t size, const uint64_t crc)
+    {
+        std::string key(path.substr(path.find_last_of("/\\") + 1));
+        key += '\0';
+        key += std::to_string(size);
+        key += ':';
+        key += std::to_string(crc);
+        return key;
+    }
+
+    /**
+     * @return The cached header for pluginKey, calling read() to fill the cache on a miss. Two workers missing on the
+     * same key at the same time may both read it; the first result to land is kept.
+     */
+    template <typename Reader> PluginHeader getOrRead(const std::string& pluginKey, Reader&& read)
+    {
+        {
+            std::shared_lock lock(mMutex);
+            if (const auto it = mHeaders.find(pluginKey); it != mHeaders.end()) {
+                return it->second;
+            }
+        }
+
+        // Read outside the lock so workers don't serialize on plugin I/O
+        auto header = read();
+
+        std::unique_lock lock(mMutex);
+        return mHeaders.try_emplace(pluginKey, std::move(header)).first->second;
+    }
+
+    /**
+     * @return true if pluginKey's header is cached. Entries are never evicted, so once true it stays true.
+     */
+    [[nodiscard]] bool contains(const std::string& pluginKey) const
+    {
+        std::shared_lock lock(mMutex);
+        return mHeaders.contains(pluginKey);
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        std::shared_lock lock(mMutex);
+        return mHeaders.size();
+    }
+
+  private:
+    mutable std::shared_mutex mMutex;
+    std::unordered_map<std::string, PluginHeader> mHeaders;
+};
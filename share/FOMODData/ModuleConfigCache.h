@@ -0,0 +1,229 @@
+#pragma once
+
+#include "BinaryIO.h"
+#include "ModuleConfigurationBinary.h"
+
+#include <xml/ModuleConfiguration.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr const char* MODULE_CONFIG_CACHE_DIR = "fomod.moduleconfigs";
+
+/*
+On-disk cache of parsed ModuleConfig.xml files, shared by the installer and the Patch Finder's rescan, so a FOMOD that
+was parsed before (on install, reinstall or an earlier rescan) is read back from its binary form instead of as XML.
+
+Entries are keyed by the XML's content, not by where it came from: one file per FOMOD and parse profile, named
+<fnv1a64 of the XML, 16 hex digits>.<full|index>.fmmc
+
+    char[4]  magic      "FMMC"
+    uint32   version    ModuleConfigCache::VERSION
+    uint64   xmlSize
+    uint64   xmlHash    fnv1a64(xml)
+    uint32   checksum   fnv1a32(body)
+    byte     body[]     ModuleConfigurationBinary
+
+A hit refreshes the entry's modification time, and trim() evicts the least recently used entries beyond the size and
+count limits. Entries are written to a temporary file and renamed into place, so workers and the installer can share
+the directory. It is only a cache: unreadable, corrupt or outdated entries are misses.
+*/
+
+class ModuleConfigCache {
+  public:
+    static constexpr char MAGIC[4]    = { 'F', 'M', 'M', 'C' };
+    static constexpr uint32_t VERSION = 1;
+
+    struct Limits {
+        uintmax_t maxBytes = 64 * 1024 * 1024;
+        size_t maxEntries  = 256;
+    };
+
+    explicit ModuleConfigCache(std::filesystem::path cacheDirectory)
+        : ModuleConfigCache(std::move(cacheDirectory), Limits {})
+    {
+    }
+
+    ModuleConfigCache(std::filesystem::path cacheDirectory, const Limits& cacheLimits)
+        : directory(std::move(cacheDirectory))
+        , limits(cacheLimits)
+    {
+    }
+
+    /**
+     * @return The cached configuration for this XML, or nullptr. An IndexOnly lookup is also served by a Full entry.
+     */
+    [[nodiscard]] std::unique_ptr<ModuleConfiguration> find(
+        const std::span<const char> xml, const ParseProfile profile) const
+    {
+        const auto hash = fnv1a64({ xml.data(), xml.size() });
+        if (auto config = load(entryPath(hash, profile), xml.size(), hash)) {
+            return config;
+        }
+        if (profile == ParseProfile::IndexOnly) {
+            return load(entryPath(hash, ParseProfile::Full), xml.size(), hash);
+        }
+        return nullptr;
+    }
+
+    /**
+     * Store a configuration parsed from xml with the given profile.
+     */
+    bool store(const std::span<const char> xml, const ParseProfile profile, const ModuleConfiguration& config) const
+    {
+        const auto hash = fnv1a64({ xml.data(), xml.size() });
+        const auto body = ModuleConfigurationBinary::serialize(config);
+
+        BinaryWriter header;
+        header.writeBytes({ MAGIC, sizeof(MAGIC) });
+        header.write<uint32_t>(VERSION);
+        header.write<uint64_t>(xml.size());
+        header.write<uint64_t>(hash);
+        header.write<uint32_t>(fnv1a32({ body.data(), body.size() }));
+
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        const auto path = entryPath(hash, profile);
+        auto tempPath   = path;
+        tempPath += "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            file.write(header.buffer().data(), static_cast<std::streamsize>(header.size()));
+            file.write(body.data(), static_cast<std::streamsize>(body.size()));
+            if (!file.good()) {
+                file.close();
+                std::filesystem::remove(tempPath, ec);
+                return false;
+            }
+        }
+        std::filesystem::rename(tempPath, path, ec);
+        if (ec) {
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Parse a ModuleConfig.xml through the cache: a hit skips XML parsing entirely, a miss parses and stores it.
+     * Throws XmlParseException like ModuleConfiguration::deserialize.
+     */
+    std::unique_ptr<ModuleConfiguration> parse(
+        const std::span<const char> xml, const ParseProfile profile = ParseProfile::Full)
+    {
+        if (auto cached = find(xml, profile)) {
+            ++hitCount;
+            return cached;
+        }
+        ++missCount;
+        auto config = std::make_unique<ModuleConfiguration>();
+        if (!config->deserialize(xml, profile)) {
+            return nullptr;
+        }
+        store(xml, profile, *config);
+        return config;
+    }
+
+    /**
+     * Delete the least recently used entries until the cache is within its limits.
+     */
+    void trim() const
+    {
+        struct Entry {
+            std::filesystem::path path;
+            uintmax_t size;
+            std::filesystem::file_time_type lastUsed;
+        };
+        std::vector<Entry> entries;
+        uintmax_t totalBytes = 0;
+        std::error_code ec;
+        for (const auto& file : std::filesystem::directory_iterator(directory, ec)) {
+            if (file.path().extension() != EXTENSION) {
+                continue;
+            }
+            Entry entry { file.path(), file.file_size(ec), file.last_write_time(ec) };
+            if (ec) {
+                continue;
+            }
+            totalBytes += entry.size;
+            entries.push_back(std::move(entry));
+        }
+
+        std::ranges::sort(entries, {}, &Entry::lastUsed);
+        auto remaining = entries.size();
+        for (const auto& entry : entries) {
+            if (totalBytes <= limits.maxBytes && remaining <= limits.maxEntries) {
+                break;
+            }
+            if (std::filesystem::remove(entry.path, ec)) {
+                totalBytes -= entry.size;
+            }
+            remaining--;
+        }
+    }
+
+    [[nodiscard]] size_t hits() const { return hitCount; }
+    [[nodiscard]] size_t misses() const { return missCount; }
+
+  private:
+    static constexpr const char* EXTENSION = ".fmmc";
+    static constexpr size_t HEADER_SIZE    = sizeof(MAGIC) + 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+
+    std::filesystem::path directory;
+    Limits limits;
+    std::atomic<size_t> hitCount { 0 };
+    std::atomic<size_t> missCount { 0 };
+
+    [[nodiscard]] std::filesystem::path entryPath(const uint64_t hash, const ParseProfile profile) const
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.%s", static_cast<unsigned long long>(hash),
+            profile == ParseProfile::Full ? "full" : "index");
+        return directory / (std::string(name) + EXTENSION);
+    }
+
+    static std::unique_ptr<ModuleConfiguration> load(
+        const std::filesystem::path& path, const uint64_t xmlSize, const uint64_t xmlHash)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return nullptr;
+        }
+        const std::vector<char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+        if (bytes.size() < HEADER_SIZE || std::memcmp(bytes.data(), MAGIC, sizeof(MAGIC)) != 0) {
+            return nullptr;
+        }
+
+        BinaryReader header(std::span<const char>(bytes), sizeof(MAGIC));
+        const auto version  = header.read<uint32_t>();
+        const auto size     = header.read<uint64_t>();
+        const auto hash     = header.read<uint64_t>();
+        const auto checksum = header.read<uint32_t>();
+        const std::span<const char> body(bytes.data() + HEADER_SIZE, bytes.size() - HEADER_SIZE);
+        if (version != VERSION || size != xmlSize || hash != xmlHash
+            || checksum != fnv1a32({ body.data(), body.size() })) {
+            return nullptr;
+        }
+
+        auto config = std::make_unique<ModuleConfiguration>();
+        if (!ModuleConfigurationBinary::deserialize(body, *config)) {
+            return nullptr;
+        }
+
+        // Recency for trim()
+        std::error_code ec;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+        return config;
+    }
+};
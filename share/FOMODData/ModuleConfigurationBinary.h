@@ -0,0 +1,319 @@
+#pragma once
+
+#include "BinaryIO.h"
+
+#include <xml/ModuleConfiguration.h>
+
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+Compact binary form of a parsed ModuleConfiguration, for ModuleConfigCache. Fields are written in declaration order
+with no names or tags, so reading one back is a straight walk that never touches XML.
+
+    Strings       uint32 length, char[length]
+    Lists         uint32 count, item[count]
+    Enums, bools  uint8
+    Optionals     uint8 present, value (if present)
+    int           int32
+
+    ModuleConfiguration
+        moduleName, HeaderImage moduleImage, CompositeDependency moduleDependencies, FileList requiredInstallFiles,
+        StepList installSteps, ConditionalFileInstall conditionalFileInstalls
+
+The remaining classes follow the same rule; see the write() overloads below. There is no header or version: the cache
+file that holds this carries both.
+*/
+
+class ModuleConfigurationBinary {
+  public:
+    static constexpr uint32_t MAX_NESTING = 64; // Guards against corrupt files recursing forever
+
+    static std::vector<char> serialize(const ModuleConfiguration& config)
+    {
+        BinaryWriter out;
+        writeString(out, config.moduleName);
+        write(out, config.moduleImage);
+        write(out, config.moduleDependencies);
+        write(out, config.requiredInstallFiles);
+        write(out, config.installSteps);
+        write(out, config.conditionalFileInstalls);
+        return out.release();
+    }
+
+    /**
+     * Decode a configuration written by serialize(). The span is only borrowed for the duration of the call.
+     * @return false if the data is truncated or corrupt. `out` is in an unspecified state in that case.
+     */
+    static bool deserialize(const std::span<const char> data, ModuleConfiguration& out)
+    {
+        BinaryReader in(data);
+        readString(in, out.moduleName);
+        read(in, out.moduleImage);
+        read(in, out.moduleDependencies, 0);
+        read(in, out.requiredInstallFiles);
+        read(in, out.installSteps);
+        read(in, out.conditionalFileInstalls);
+        return !in.failed() && in.remaining() == 0;
+    }
+
+  private:
+    static void writeString(BinaryWriter& out, const std::string_view str)
+    {
+        out.write<uint32_t>(static_cast<uint32_t>(str.size()));
+        out.writeBytes(str);
+    }
+
+    static void readString(BinaryReader& in, std::string& str) { str = in.readBytes(in.read<uint32_t>()); }
+
+    template <typename Enum> static void writeEnum(BinaryWriter& out, const Enum value)
+    {
+        out.write<uint8_t>(static_cast<uint8_t>(value));
+    }
+
+    template <typename Enum> static Enum readEnum(BinaryReader& in) { return static_cast<Enum>(in.read<uint8_t>()); }
+
+    template <typename T> static void writeList(BinaryWriter& out, const std::vector<T>& list)
+    {
+        out.write<uint32_t>(static_cast<uint32_t>(list.size()));
+        for (const auto& item : list) {
+            write(out, item);
+        }
+    }
+
+    // Every item takes at least one byte, so a count larger than what is left is corrupt; checking it up front keeps
+    // reserve() from being handed garbage.
+    template <typename T, typename... Args>
+    static void readList(BinaryReader& in, std::vector<T>& list, const Args&... args)
+    {
+        const auto count = in.read<uint32_t>();
+        if (count > in.remaining()) {
+            in.fail();
+            return;
+        }
+        list.clear();
+        list.reserve(count);
+        for (uint32_t i = 0; i < count && !in.failed(); ++i) {
+            read(in, list.emplace_back(), args...);
+        }
+    }
+
+    static void write(BinaryWriter& out, const FileDependency& dependency)
+    {
+        writeString(out, dependency.file);
+        writeEnum(out, dependency.state);
+    }
+
+    static void read(BinaryReader& in, FileDependency& dependency)
+    {
+        readString(in, dependency.file);
+        dependency.state = readEnum<FileDependencyTypeEnum>(in);
+    }
+
+    static void write(BinaryWriter& out, const FlagDependency& dependency)
+    {
+        writeString(out, dependency.flag);
+        writeString(out, dependency.value);
+    }
+
+    static void read(BinaryReader& in, FlagDependency& dependency)
+    {
+        readString(in, dependency.flag);
+        readString(in, dependency.value);
+    }
+
+    static void write(BinaryWriter& out, const GameDependency& dependency) { writeString(out, dependency.version); }
+
+    static void read(BinaryReader& in, GameDependency& dependency) { readString(in, dependency.version); }
+
+    static void write(BinaryWriter& out, const CompositeDependency& dependency)
+    {
+        writeEnum(out, dependency.operatorType);
+        writeList(out, dependency.fileDependencies);
+        writeList(out, dependency.flagDependencies);
+        writeList(out, dependency.gameDependencies);
+        writeList(out, dependency.nestedDependencies);
+    }
+
+    static void read(BinaryReader& in, CompositeDependency& dependency, const uint32_t depth)
+    {
+        if (depth > MAX_NESTING) {
+            in.fail();
+            return;
+        }
+        dependency.operatorType = readEnum<OperatorTypeEnum>(in);
+        readList(in, dependency.fileDependencies);
+        readList(in, dependency.flagDependencies);
+        readList(in, dependency.gameDependencies);
+        readList(in, dependency.nestedDependencies, depth + 1);
+    }
+
+    static void write(BinaryWriter& out, const DependencyPattern& pattern)
+    {
+        write(out, pattern.dependencies);
+        writeEnum(out, pattern.type);
+    }
+
+    static void read(BinaryReader& in, DependencyPattern& pattern)
+    {
+        read(in, pattern.dependencies, 0);
+        pattern.type = readEnum<PluginTypeEnum>(in);
+    }
+
+    static void write(BinaryWriter& out, const TypeDescriptor& descriptor)
+    {
+        const auto& defaultType = descriptor.dependencyType.defaultType;
+        out.write<uint8_t>(defaultType.has_value());
+        if (defaultType) {
+            writeEnum(out, *defaultType);
+        }
+        writeList(out, descriptor.dependencyType.patterns.patterns);
+        writeEnum(out, descriptor.type);
+    }
+
+    static void read(BinaryReader& in, TypeDescriptor& descriptor)
+    {
+        auto& defaultType = descriptor.dependencyType.defaultType;
+        defaultType       = in.read<uint8_t>() ? std::optional(readEnum<PluginTypeEnum>(in)) : std::nullopt;
+        readList(in, descriptor.dependencyType.patterns.patterns);
+        descriptor.type = readEnum<PluginTypeEnum>(in);
+    }
+
+    static void write(BinaryWriter& out, const HeaderImage& image)
+    {
+        writeString(out, image.path);
+        out.write<uint8_t>(image.showImage);
+        out.write<uint8_t>(image.showFade);
+        out.write<int32_t>(image.height);
+    }
+
+    static void read(BinaryReader& in, HeaderImage& image)
+    {
+        readString(in, image.path);
+        image.showImage = in.read<uint8_t>() != 0;
+        image.showFade  = in.read<uint8_t>() != 0;
+        image.height    = in.read<int32_t>();
+    }
+
+    static void write(BinaryWriter& out, const File& file)
+    {
+        writeString(out, file.source);
+        out.write<uint8_t>(file.destination.has_value());
+        if (file.destination) {
+            writeString(out, *file.destination);
+        }
+        out.write<int32_t>(file.priority);
+        out.write<uint8_t>(file.isFolder);
+    }
+
+    static void read(BinaryReader& in, File& file)
+    {
+        readString(in, file.source);
+        if (in.read<uint8_t>()) {
+            readString(in, file.destination.emplace());
+        } else {
+            file.destination.reset();
+        }
+        file.priority = in.read<int32_t>();
+        file.isFolder = in.read<uint8_t>() != 0;
+    }
+
+    static void write(BinaryWriter& out, const FileList& files) { writeList(out, files.files); }
+
+    static void read(BinaryReader& in, FileList& files) { readList(in, files.files); }
+
+    static void write(BinaryWriter& out, const ConditionFlag& flag)
+    {
+        writeString(out, flag.name);
+        writeString(out, flag.value);
+    }
+
+    static void read(BinaryReader& in, ConditionFlag& flag)
+    {
+        readString(in, flag.name);
+        readString(in, flag.value);
+    }
+
+    static void write(BinaryWriter& out, const Plugin& plugin)
+    {
+        writeString(out, plugin.name);
+        writeString(out, plugin.description);
+        writeString(out, plugin.image.path);
+        write(out, plugin.typeDescriptor);
+        writeList(out, plugin.conditionFlags.flags);
+        write(out, plugin.files);
+    }
+
+    static void read(BinaryReader& in, Plugin& plugin)
+    {
+        readString(in, plugin.name);
+        readString(in, plugin.description);
+        readString(in, plugin.image.path);
+        read(in, plugin.typeDescriptor);
+        readList(in, plugin.conditionFlags.flags);
+        read(in, plugin.files);
+    }
+
+    static void write(BinaryWriter& out, const Group& group)
+    {
+        writeString(out, group.name);
+        writeEnum(out, group.type);
+        writeEnum(out, group.plugins.order);
+        writeList(out, group.plugins.plugins);
+    }
+
+    static void read(BinaryReader& in, Group& group)
+    {
+        readString(in, group.name);
+        group.type          = readEnum<GroupTypeEnum>(in);
+        group.plugins.order = readEnum<OrderTypeEnum>(in);
+        readList(in, group.plugins.plugins);
+    }
+
+    static void write(BinaryWriter& out, const InstallStep& step)
+    {
+        writeString(out, step.name);
+        write(out, step.visible);
+        writeEnum(out, step.optionalFileGroups.order);
+        writeList(out, step.optionalFileGroups.groups);
+    }
+
+    static void read(BinaryReader& in, InstallStep& step)
+    {
+        readString(in, step.name);
+        read(in, step.visible, 0);
+        step.optionalFileGroups.order = readEnum<OrderTypeEnum>(in);
+        readList(in, step.optionalFileGroups.groups);
+    }
+
+    static void write(BinaryWriter& out, const StepList& steps)
+    {
+        writeEnum(out, steps.order);
+        writeList(out, steps.installSteps);
+    }
+
+    static void read(BinaryReader& in, StepList& steps)
+    {
+        steps.order = readEnum<OrderTypeEnum>(in);
+        readList(in, steps.installSteps);
+    }
+
+    static void write(BinaryWriter& out, const ConditionalFileInstallPattern& pattern)
+    {
+        write(out, pattern.dependencies);
+        write(out, pattern.files);
+    }
+
+    static void read(BinaryReader& in, ConditionalFileInstallPattern& pattern)
+    {
+        read(in, pattern.dependencies, 0);
+        read(in, pattern.files);
+    }
+
+    static void write(BinaryWriter& out, const ConditionalFileInstall& install) { writeList(out, install.patterns); }
+
+    static void read(BinaryReader& in, ConditionalFileInstall& install) { readList(in, install.patterns); }
+};
@@ -1,18 +1,94 @@
 ﻿#pragma once
 
+#include "BinaryIO.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
-#include <fstream>
+#include <cstring>
+#include <optional>
+#include <span>
 #include <string>
-#include <unordered_set>
+#include <string_view>
+#include <thread>
 #include <vector>
 
-static const std::unordered_set<std::string> VANILLA_MASTERS
+constexpr std::array<std::string_view, 5> VANILLA_MASTERS
     = { "Skyrim.esm", "Update.esm", "Dawnguard.esm", "HearthFires.esm", "Dragonborn.esm" };
 
+constexpr bool isVanillaMaster(const std::string_view fileName)
+{
+    return std::ranges::find(VANILLA_MASTERS, fileName) != VANILLA_MASTERS.end();
+}
+
+/**
+ * The TES4 header record of a plugin, read into memory, and the plugin's '/'-separated path inside its archive.
+ * The header record is all the DB needs from a plugin, so this is what in-memory extraction keeps.
+ */
+struct ExtractedPlugin {
+    std::string archivePath;
+    std::vector<char> header;
+    uint64_t size = 0; // Uncompressed size and CRC, as listed by the archive
+    uint64_t crc  = 0;
+};
+
+/**
+ * The TES4 header record of a plugin, parsed in place. The views point into the data it was parsed from, or into
+ * storage if the record was compressed, so it can be moved but not copied.
+ */
+struct PluginHeaderView {
+    bool valid     = false; // Starts with a TES4 record; the fields below may still be partial for truncated data
+    uint32_t flags = 0;
+    std::vector<std::string_view> masters;
+    uint32_t recordCount       = 0; // HEDR: records and groups in the plugin
+    uint32_t authorOffset      = 0; // CNAM and SNAM data, as offsets into the record's subrecords; 0 if absent
+    uint32_t descriptionOffset = 0;
+    uint32_t overrideCount     = 0; // ONAM: form IDs of the masters' records this plugin overrides
+    uint32_t internalCellCount = 0; // INCC
+    std::vector<char> storage;
+
+    PluginHeaderView()                                   = default;
+    PluginHeaderView(PluginHeaderView&&)                 = default;
+    PluginHeaderView& operator=(PluginHeaderView&&)      = default;
+    PluginHeaderView(const PluginHeaderView&)            = delete;
+    PluginHeaderView& operator=(const PluginHeaderView&) = delete;
+};
+
+/**
+ * What the DB keeps about a plugin, from one pass over its TES4 record. The checksum covers that record only, so it
+ * identifies a plugin version cheaply, without reading the rest of a possibly huge file.
+ */
+struct PluginHeader {
+    bool valid = false;
+    std::vector<std::string> masters;
+    uint32_t flags             = 0;
+    uint32_t recordCount       = 0;
+    uint32_t authorOffset      = 0;
+    uint32_t descriptionOffset = 0;
+    uint32_t checksum          = 0; // fnv1a32 of the TES4 record
+};
+
 class PluginReader {
   public:
+    // Record header: type, data size, flags, formId, timestamp, version control, internal version, unknown.
+    static constexpr size_t RECORD_HEADER_SIZE = 24;
+
+    // Subrecord header: type, data size.
+    static constexpr size_t SUBRECORD_HEADER_SIZE = 6;
+
+    // Record flag: the record's data is a uint32 decompressed size followed by a zlib stream.
+    static constexpr uint32_t FLAG_COMPRESSED = 0x00040000;
+
+    // Upper bound on the TES4 record read from a file. Real ones are a few KB even with 254 masters; this only
+    // guards against allocating gigabytes for a corrupt size field.
+    static constexpr uint32_t MAX_HEADER_RECORD_SIZE = 16 * 1024 * 1024;
+
     /**
-     * Reads the master files from a Bethesda plugin file (ESP/ESM/ESL)
+     * Reads the master files from a Bethesda plugin file (ESP/ESM/ESL). The file is mapped, and only the pages of its
+     * TES4 record are touched.
      * @param filePath Path to the plugin file
      * @param trimVanilla Exclude the vanilla game masters or not. Mostly to save DB space.
      * @return Vector of master filenames
@@ -20,76 +96,161 @@ class PluginReader {
     static std::vector<std::string> readMasters(const std::string& filePath, const bool trimVanilla = false)
     {
         std::vector<std::string> masters;
-        std::ifstream file(filePath, std::ios::binary);
+        withMappedFile(filePath, [&](const std::span<const char> data) {
+            masters = toStrings(parseHeader(data).masters, trimVanilla);
+        });
+        return masters;
+    }
 
-        if (!file) {
-            return masters;
-        }
+    /**
+     * Reads a plugin's header metadata and masters from a single pass over its mapped TES4 record.
+     * @param filePath Path to the plugin file
+     * @param trimVanilla Exclude the vanilla game masters or not. Mostly to save DB space.
+     * @return The header; not valid if the file can't be read or isn't a plugin.
+     */
+    static PluginHeader readHeader(const std::string& filePath, const bool trimVanilla = false)
+    {
+        PluginHeader header;
+        withMappedFile(filePath, [&](const std::span<const char> data) {
+            header = readHeaderFromBuffer(data, trimVanilla);
+        });
+        return header;
+    }
 
-        // Check TES4 record signature
-        char signature[4];
-        file.read(signature, 4);
-        if (strncmp(signature, "TES4", 4) != 0) {
-            return masters;
+    /**
+     * Same as above, for plugin data in memory. Like readMastersFromBuffer(), data can be a prefix of the plugin.
+     */
+    static PluginHeader readHeaderFromBuffer(const std::span<const char> data, const bool trimVanilla = false)
+    {
+        const auto view = parseHeader(data);
+        PluginHeader header;
+        header.valid             = view.valid;
+        header.masters           = toStrings(view.masters, trimVanilla);
+        header.flags             = view.flags;
+        header.recordCount       = view.recordCount;
+        header.authorOffset      = view.authorOffset;
+        header.descriptionOffset = view.descriptionOffset;
+        if (view.valid && data.size() >= RECORD_HEADER_SIZE) {
+            header.checksum = fnv1a32({ data.data(), std::min(data.size(), recordSize(data)) });
         }
+        return header;
+    }
 
-        // Read record size
-        uint32_t recordSize;
-        file.read(reinterpret_cast<char*>(&recordSize), 4);
-
-        constexpr uint32_t skipSize = sizeof(uint32_t) // flags
-            + sizeof(uint32_t) // formId
-            + sizeof(uint16_t) // timestamp
-            + sizeof(uint16_t) // version control
-            + sizeof(uint16_t) // internal version
-            + sizeof(uint16_t); // unknown
+    /**
+     * Reads the masters of many plugin files, spread across threads. Results are in the order of filePaths; a file
+     * that can't be read gets no masters.
+     * @param threadCount Number of threads, 0 for one per core
+     */
+    static std::vector<std::vector<std::string>> readMastersBatch(
+        const std::vector<std::string>& filePaths, const bool trimVanilla = false, const unsigned threadCount = 0)
+    {
+        std::vector<std::vector<std::string>> results(filePaths.size());
+        std::atomic<size_t> next = 0;
+        const auto worker        = [&] {
+            for (size_t i = next++; i < filePaths.size(); i = next++) {
+                results[i] = readMasters(filePaths[i], trimVanilla);
+            }
+        };
 
-        // Skip header flags, formID, etc. (total 8 bytes)
-        file.seekg(skipSize, std::ios::cur);
+        const auto threads = std::min<size_t>(
+            threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency()), filePaths.size());
+        if (threads <= 1) {
+            worker();
+            return results;
+        }
+        std::vector<std::jthread> workers;
+        workers.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers.emplace_back(worker);
+        }
+        workers.clear(); // Joins
+        return results;
+    }
 
-        // Calculate where the TES4 record ends
-        std::streampos recordEnd = file.tellg() + static_cast<std::streampos>(recordSize);
+    /**
+     * Reads the master files from plugin data in memory. Only the TES4 header record is looked at, so data can be a
+     * prefix of the plugin (see readHeaderRecord()). Parsing stops quietly where the data ends.
+     * @param data The plugin's bytes, starting at the TES4 record
+     * @param trimVanilla Exclude the vanilla game masters or not. Mostly to save DB space.
+     * @return Vector of master filenames
+     */
+    static std::vector<std::string> readMastersFromBuffer(
+        const std::span<const char> data, const bool trimVanilla = false)
+    {
+        return toStrings(parseHeader(data).masters, trimVanilla);
+    }
 
-        // Read subrecords until we reach the end of the TES4 record
-        while (file && file.tellg() < recordEnd) {
-            char subRecordType[4];
-            uint16_t subRecordSize;
+    /**
+     * Walks the subrecords of the TES4 record in place. Nothing is copied unless the record is compressed.
+     * @param data The plugin's bytes, starting at the TES4 record. May be a prefix of the plugin; parsing stops
+     * quietly where the data ends.
+     */
+    static PluginHeaderView parseHeader(const std::span<const char> data)
+    {
+        PluginHeaderView header;
+        BinaryReader reader(data);
 
-            // Read subrecord type and size
-            file.read(subRecordType, 4);
-            file.read(reinterpret_cast<char*>(&subRecordSize), 2);
+        // Check TES4 record signature
+        if (reader.readBytes(4) != "TES4") {
+            return header;
+        }
+        header.valid = true;
 
-            if (strncmp(subRecordType, "MAST", 4) == 0) {
-                // Read master filename (null-terminated string)
-                std::string masterName;
-                masterName.resize(subRecordSize);
-                file.read(masterName.data(), subRecordSize);
+        // Read record size and flags, then skip formID, etc. to the first subrecord
+        const auto recordSize = reader.read<uint32_t>();
+        header.flags          = reader.read<uint32_t>();
+        reader.seek(RECORD_HEADER_SIZE);
+        if (reader.failed()) {
+            return header;
+        }
 
+        auto fields = data.subspan(RECORD_HEADER_SIZE, std::min<size_t>(recordSize, data.size() - RECORD_HEADER_SIZE));
+        if ((header.flags & FLAG_COMPRESSED) != 0) {
+            header.storage = decompress(fields);
+            fields         = header.storage;
+        }
+        const auto offsetOf = [&fields](const std::string_view subrecord) {
+            return static_cast<uint32_t>(subrecord.data() - fields.data());
+        };
+        forEachSubrecord(fields, [&](const std::string_view type, std::string_view subrecord) {
+            if (type == "HEDR" && subrecord.size() >= 2 * sizeof(uint32_t)) {
+                // float version, then the record count
+                std::memcpy(&header.recordCount, subrecord.data() + sizeof(float), sizeof(uint32_t));
+            } else if (type == "CNAM") {
+                header.authorOffset = offsetOf(subrecord);
+            } else if (type == "SNAM") {
+                header.descriptionOffset = offsetOf(subrecord);
+            } else if (type == "MAST") {
                 // Remove null terminator if present
-                if (!masterName.empty() && masterName.back() == '\0') {
-                    masterName.pop_back();
+                if (!subrecord.empty() && subrecord.back() == '\0') {
+                    subrecord.remove_suffix(1);
                 }
-
-                // Only add if it's not a vanilla master or if we're not trimming
-                if (!trimVanilla || !VANILLA_MASTERS.contains(masterName)) {
-                    masters.push_back(masterName);
-                }
-
-                // Each MAST is followed by a DATA subrecord
-                char dataType[4];
-                uint16_t dataSize;
-                file.read(dataType, 4);
-                file.read(reinterpret_cast<char*>(&dataSize), 2);
-
-                // Skip DATA content (usually an 8-byte value)
-                file.seekg(dataSize, std::ios::cur);
-            } else {
-                // Skip other subrecord types
-                file.seekg(subRecordSize, std::ios::cur);
+                header.masters.push_back(subrecord);
+            } else if (type == "ONAM") {
+                header.overrideCount = static_cast<uint32_t>(subrecord.size() / sizeof(uint32_t));
+            } else if (type == "INCC" && subrecord.size() >= sizeof(uint32_t)) {
+                std::memcpy(&header.internalCellCount, subrecord.data(), sizeof(uint32_t));
             }
-        }
+        });
+        return header;
+    }
 
-        return masters;
+    /**
+     * Reads just the TES4 header record of a plugin file, which is all readMasters() needs.
+     * @param filePath Path to the plugin file
+     * @return The record's bytes, or as much of it as the file has. Empty if the file can't be read.
+     */
+    static std::vector<char> readHeaderRecord(const std::string& filePath)
+    {
+        std::vector<char> record;
+        withMappedFile(filePath, [&record](const std::span<const char> data) {
+            if (data.size() < RECORD_HEADER_SIZE) {
+                return;
+            }
+            const auto end = data.begin() + static_cast<std::ptrdiff_t>(std::min(data.size(), recordSize(data)));
+            record.assign(data.begin(), end);
+        });
+        return record;
     }
 
     /**
@@ -99,15 +260,98 @@ class PluginReader {
      */
     static bool isValidPlugin(const std::string& filePath)
     {
-        std::ifstream file(filePath, std::ios::binary);
+        bool valid = false;
+        withMappedFile(filePath, [&valid](const std::span<const char> data) {
+            valid = data.size() >= 4 && std::memcmp(data.data(), "TES4", 4) == 0;
+        });
+        return valid;
+    }
+
+  private:
+    // Size of the TES4 record including its header, capped at MAX_HEADER_RECORD_SIZE. data must hold the header.
+    static size_t recordSize(const std::span<const char> data)
+    {
+        uint32_t size;
+        std::memcpy(&size, data.data() + 4, sizeof(size));
+        return RECORD_HEADER_SIZE + std::min(size, MAX_HEADER_RECORD_SIZE);
+    }
 
-        if (!file) {
-            return false;
+    /**
+     * Maps the file and hands its bytes to use(). Does nothing if the file can't be opened or is empty.
+     */
+    template <typename Use> static void withMappedFile(const std::string& filePath, Use&& use)
+    {
+        QFile file(QString::fromStdString(filePath));
+        if (!file.open(QIODevice::ReadOnly) || file.size() == 0) {
+            return;
         }
+        const auto size = file.size();
+        auto* mapped    = file.map(0, size);
+        if (mapped == nullptr) {
+            return;
+        }
+        use(std::span(reinterpret_cast<const char*>(mapped), static_cast<size_t>(size)));
+        file.unmap(mapped);
+    }
+
+    /**
+     * Calls visit(type, data) for each subrecord. An XXXX subrecord carries the size of the next one, whose own
+     * 16-bit size field is then ignored.
+     */
+    template <typename Visit> static void forEachSubrecord(const std::span<const char> fields, Visit&& visit)
+    {
+        BinaryReader reader(fields);
+        std::optional<uint32_t> extendedSize;
+        while (!reader.failed() && reader.offset() < fields.size()) {
+            const auto type = reader.readBytes(4);
+            const auto size = reader.read<uint16_t>();
+            const auto data = reader.readBytes(extendedSize.value_or(size));
+            if (reader.failed()) {
+                break;
+            }
+            extendedSize.reset();
+            if (type == "XXXX" && data.size() == sizeof(uint32_t)) {
+                std::memcpy(&extendedSize.emplace(), data.data(), sizeof(uint32_t));
+                continue;
+            }
+            visit(type, data);
+        }
+    }
 
-        char signature[4];
-        file.read(signature, 4);
+    // Compressed record data is the decompressed size (little-endian) and a zlib stream. qUncompress() wants the
+    // same, but with a big-endian size.
+    static std::vector<char> decompress(const std::span<const char> data)
+    {
+        if (data.size() <= sizeof(uint32_t)) {
+            return {};
+        }
+        uint32_t size;
+        std::memcpy(&size, data.data(), sizeof(size));
+        if (size > MAX_HEADER_RECORD_SIZE) {
+            return {};
+        }
+
+        QByteArray compressed;
+        compressed.reserve(static_cast<qsizetype>(data.size()));
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            compressed.append(static_cast<char>((size >> shift) & 0xFF));
+        }
+        compressed.append(data.data() + sizeof(uint32_t), static_cast<qsizetype>(data.size() - sizeof(uint32_t)));
 
-        return strncmp(signature, "TES4", 4) == 0;
+        const auto decompressed = qUncompress(compressed);
+        return { decompressed.begin(), decompressed.end() };
+    }
+
+    static std::vector<std::string> toStrings(const std::vector<std::string_view>& masters, const bool trimVanilla)
+    {
+        std::vector<std::string> result;
+        result.reserve(masters.size());
+        for (const auto master : masters) {
+            // Only add if it's not a vanilla master or if we're not trimming
+            if (!trimVanilla || !isVanillaMaster(master)) {
+                result.emplace_back(master);
+            }
+        }
+        return result;
     }
 };
\ No newline at end of file
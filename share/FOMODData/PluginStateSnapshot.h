@@ -0,0 +1,107 @@
+#pragma once
+
+#include "FomodDBEntry.h"
+#include "StringPool.h"
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/*
+The load order state of every known file: plugin name -> StoredFileState.
+
+It is filled from the plugin list (and any non-plugin files the DB's conditions reference) when the Patch Finder is
+populated, then kept current through set() as plugins change state and mods are installed or removed, so a change
+only touches the files it affects. Lookups are keyed by interned StringId, so the common case is a pointer hash with
+no string hashing, no allocation and no type erasure. Names are matched case-insensitively, like MO2's plugin list:
+each file has one state, stored under its case-folded name, and every spelling it was set with maps to that. Anything
+not in the snapshot is Missing.
+
+The snapshot is a callable, so it can be passed straight to ConditionProgram::evaluate and
+ConditionEvaluator::resolveMatchingType(option, resolver).
+*/
+
+class PluginStateSnapshot {
+  public:
+    /**
+     * Record the state of a file. Later calls for the same name (case-insensitively) replace earlier ones.
+     */
+    void set(const std::string_view fileName, const StoredFileState state)
+    {
+        const StringId exact(fileName);
+        const auto folded = foldCase(fileName);
+        const auto key    = folded == fileName ? exact : StringId(folded);
+        mStates[key]      = state;
+        mSpellings[exact] = key;
+    }
+
+    [[nodiscard]] StoredFileState state(const StringId fileName) const
+    {
+        if (const auto it = mSpellings.find(fileName); it != mSpellings.end()) {
+            return mStates.at(it->second);
+        }
+        return foldedState(fileName.str());
+    }
+
+    [[nodiscard]] StoredFileState state(const std::string_view fileName) const
+    {
+        if (const auto exact = StringId::find(fileName)) {
+            if (const auto it = mSpellings.find(*exact); it != mSpellings.end()) {
+                return mStates.at(it->second);
+            }
+        }
+        return foldedState(fileName);
+    }
+
+    StoredFileState operator()(const StringId fileName) const { return state(fileName); }
+
+    [[nodiscard]] size_t size() const { return mStates.size(); }
+
+    void clear()
+    {
+        mStates.clear();
+        mSpellings.clear();
+    }
+
+  private:
+    // Plugin names fit comfortably; longer names take the allocating path.
+    static constexpr size_t FOLD_BUFFER_SIZE = 260;
+
+    std::unordered_map<StringId, StoredFileState> mStates; // By case-folded name
+    std::unordered_map<StringId, StringId> mSpellings; // Every name set() was called with -> its key in mStates
+
+    static char toLowerAscii(const char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; }
+
+    static std::string foldCase(const std::string_view str)
+    {
+        std::string folded(str);
+        for (auto& c : folded) {
+            c = toLowerAscii(c);
+        }
+        return folded;
+    }
+
+    // Second chance for spellings set() never saw. The folded name was interned when the snapshot was built, so a name
+    // that folds to something never interned can't be in the load order.
+    [[nodiscard]] StoredFileState foldedState(const std::string_view fileName) const
+    {
+        std::optional<StringId> folded;
+        if (fileName.size() <= FOLD_BUFFER_SIZE) {
+            std::array<char, FOLD_BUFFER_SIZE> buffer;
+            for (size_t i = 0; i < fileName.size(); ++i) {
+                buffer[i] = toLowerAscii(fileName[i]);
+            }
+            folded = StringId::find({ buffer.data(), fileName.size() });
+        } else {
+            folded = StringId::find(foldCase(fileName));
+        }
+
+        if (folded) {
+            if (const auto it = mStates.find(*folded); it != mStates.end()) {
+                return it->second;
+            }
+        }
+        return StoredFileState::Missing;
+    }
+};
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+Process-wide interning pool for the names that repeat across the whole DB: plugin file names, masters, and
+step/group/option names. "Skyrim.esm" or "Page One" is stored once no matter how many options reference it, and
+equality between two interned names is a pointer compare.
+
+Interned strings live for the rest of the process. Only names that end up in the DB (or in plugin lookups built from
+the load order) are interned, so the pool is bounded by the distinct names the user actually has.
+*/
+
+class StringId;
+
+class StringPool {
+  public:
+    static StringPool& instance()
+    {
+        static StringPool pool;
+        return pool;
+    }
+
+    /**
+     * @return The pooled copy of str, adding it if this is the first time it is seen.
+     */
+    const std::string* intern(const std::string_view str)
+    {
+        if (str.empty()) {
+            return &EMPTY;
+        }
+        {
+            std::shared_lock lock(mMutex);
+            if (const auto it = mIds.find(str); it != mIds.end()) {
+                return it->second;
+            }
+        }
+        std::unique_lock lock(mMutex);
+        if (const auto it = mIds.find(str); it != mIds.end()) {
+            return it->second;
+        }
+        const auto* pooled = &mStrings.emplace_back(str);
+        mIds.emplace(*pooled, pooled);
+        return pooled;
+    }
+
+    /**
+     * @return The pooled copy of str, or nullptr if it was never interned. Never grows the pool.
+     */
+    const std::string* find(const std::string_view str) const
+    {
+        if (str.empty()) {
+            return &EMPTY;
+        }
+        std::shared_lock lock(mMutex);
+        const auto it = mIds.find(str);
+        return it != mIds.end() ? it->second : nullptr;
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        std::shared_lock lock(mMutex);
+        return mStrings.size();
+    }
+
+    inline static const std::string EMPTY;
+
+  private:
+    StringPool() = default;
+
+    mutable std::shared_mutex mMutex;
+    // std::deque keeps element addresses stable, so handles and map keys can point into it.
+    std::deque<std::string> mStrings;
+    std::unordered_map<std::string_view, const std::string*> mIds;
+};
+
+/**
+ * Handle to an interned string. Cheap to copy (one pointer) and compared by identity. Converts implicitly to and
+ * from std::string so it can stand in for the string fields it replaced.
+ */
+class StringId {
+  public:
+    StringId() = default;
+
+    StringId(const std::string_view str)
+        : mStr(StringPool::instance().intern(str))
+    {
+    }
+
+    StringId(const std::string& str)
+        : StringId(std::string_view(str))
+    {
+    }
+
+    StringId(const char* str)
+        : StringId(std::string_view(str))
+    {
+    }
+
+    /**
+     * @return The handle for str if it has been interned before. A name that was never interned can't be equal to
+     * any StringId, so lookups with arbitrary input use this instead of growing the pool.
+     */
+    static std::optional<StringId> find(const std::string_view str)
+    {
+        const auto* pooled = StringPool::instance().find(str);
+        return pooled != nullptr ? std::optional(StringId(pooled)) : std::nullopt;
+    }
+
+    [[nodiscard]] const std::string& str() const { return *mStr; }
+    [[nodiscard]] bool empty() const { return mStr->empty(); }
+    [[nodiscard]] size_t size() const { return mStr->size(); }
+
+    operator const std::string&() const { return *mStr; }
+
+    friend bool operator==(const StringId& a, const StringId& b) { return a.mStr == b.mStr; }
+    friend bool operator==(const StringId& a, const std::string& b) { return *a.mStr == b; }
+    friend bool operator==(const StringId& a, const std::string_view b) { return *a.mStr == b; }
+    friend bool operator==(const StringId& a, const char* b) { return *a.mStr == b; }
+
+    friend std::ostream& operator<<(std::ostream& os, const StringId& id) { return os << *id.mStr; }
+
+  private:
+    friend struct std::hash<StringId>;
+
+    explicit StringId(const std::string* pooled)
+        : mStr(pooled)
+    {
+    }
+
+    const std::string* mStr = &StringPool::EMPTY;
+};
+
+template <> struct std::hash<StringId> {
+    size_t operator()(const StringId& id) const noexcept { return std::hash<const std::string*>()(id.mStr); }
+};
+
+inline std::vector<StringId> toStringIds(const std::vector<std::string>& strings)
+{
+    return std::vector<StringId>(strings.begin(), strings.end());
+}
+
+inline void to_json(nlohmann::json& j, const StringId& id) { j = id.str(); }
+
+inline void from_json(const nlohmann::json& j, StringId& id) { id = StringId(j.get<std::string>()); }
@@ -2,8 +2,10 @@
 #define STRINGCONSTANTS_H
 #include <QString>
 #include <algorithm>
+#include <cwctype>
 #include <regex>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace StringConstants {
@@ -89,13 +91,30 @@ inline std::string toLower(const std::string& str)
     return lowerStr;
 }
 
-inline bool endsWithCaseInsensitive(const std::wstring& str, const std::wstring& suffix)
+inline bool endsWithCaseInsensitive(const std::wstring_view str, const std::wstring_view suffix)
 {
-    const std::wstring lowerStr = toLower(str);
-    if (const std::wstring lowerSuffix = toLower(suffix); lowerStr.length() >= lowerSuffix.length()) {
-        return 0 == lowerStr.compare(lowerStr.length() - lowerSuffix.length(), lowerSuffix.length(), lowerSuffix);
+    if (str.length() < suffix.length()) {
+        return false;
     }
-    return false;
+    return std::equal(suffix.begin(), suffix.end(), str.end() - static_cast<std::ptrdiff_t>(suffix.length()),
+        [](const wchar_t a, const wchar_t b) { return towlower(a) == towlower(b); });
+}
+
+// Suffix test for archive entry paths: case-insensitive (ASCII, which is all FOMOD file names need) and treating '/'
+// and '\' alike. Nothing is allocated, so it is cheap enough to run over every entry of a 50k-file texture archive.
+inline bool endsWithPathCaseInsensitive(const std::wstring_view path, const std::wstring_view suffix)
+{
+    if (path.length() < suffix.length()) {
+        return false;
+    }
+    const auto fold = [](const wchar_t c) {
+        if (c == L'\\') {
+            return L'/';
+        }
+        return c >= L'A' && c <= L'Z' ? static_cast<wchar_t>(c - L'A' + L'a') : c;
+    };
+    return std::equal(suffix.begin(), suffix.end(), path.end() - static_cast<std::ptrdiff_t>(suffix.length()),
+        [&fold](const wchar_t a, const wchar_t b) { return fold(a) == fold(b); });
 }
 
 inline QString formatPluginDescription(const QString& text)
@@ -129,4 +148,10 @@ inline bool isPluginFile(const std::string& file)
     return lower.ends_with("esl") || lower.ends_with("esp") || lower.ends_with("esm");
 }
 
+inline bool isPluginFile(const std::wstring_view file)
+{
+    return endsWithPathCaseInsensitive(file, L"esl") || endsWithPathCaseInsensitive(file, L"esp")
+        || endsWithPathCaseInsensitive(file, L"esm");
+}
+
 #endif
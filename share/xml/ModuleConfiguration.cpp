@@ -1,6 +1,9 @@
 ﻿#include "ModuleConfiguration.h"
 
+#include <algorithm>
+#include <cstring>
 #include <format>
+#include <iterator>
 
 #include "XmlHelper.h"
 #include "XmlParseException.h"
@@ -40,12 +43,15 @@ PluginTypeEnum pluginTypeFromString(const std::string& typeStr)
     return PluginTypeEnum::Optional;
 }
 
-template <typename T> bool deserializeList(pugi::xml_node& node, const char* childName, std::vector<T>& list)
+// Items are deserialized in place; a FOMOD's subtrees (groups of plugins with their files and dependencies) are never
+// copied. Extra arguments (e.g. a ParseProfile) are passed on to each item's deserialize().
+template <typename T, typename... Args>
+bool deserializeList(pugi::xml_node& node, const char* childName, std::vector<T>& list, const Args&... args)
 {
-    for (pugi::xml_node childNode : node.children(childName)) {
-        T item;
-        item.deserialize(childNode);
-        list.push_back(item);
+    const auto children = node.children(childName);
+    list.reserve(list.size() + std::distance(children.begin(), children.end()));
+    for (pugi::xml_node childNode : children) {
+        list.emplace_back().deserialize(childNode, args...);
     }
     return true;
 }
@@ -87,25 +93,67 @@ bool GameDependency::deserialize(pugi::xml_node& node)
     return true;
 }
 
+namespace {
+struct DependencyCounts {
+    size_t file   = 0;
+    size_t flag   = 0;
+    size_t game   = 0;
+    size_t nested = 0;
+    pugi::xml_node firstNested;
+
+    explicit DependencyCounts(const pugi::xml_node& node)
+    {
+        for (const pugi::xml_node child : node.children()) {
+            const char* name = child.name();
+            if (strcmp(name, "fileDependency") == 0) {
+                file++;
+            } else if (strcmp(name, "flagDependency") == 0) {
+                flag++;
+            } else if (strcmp(name, "gameDependency") == 0) {
+                game++;
+            } else if (strcmp(name, "dependencies") == 0) {
+                if (nested++ == 0) {
+                    firstNested = child;
+                }
+            }
+        }
+    }
+};
+}
+
 bool CompositeDependency::deserialize(pugi::xml_node& node)
 {
 
     // this could EITHER have a dependencies child or the dependencies are here.
     // turns out they could have both.
     pugi::xml_node possibleNode = node;
+    DependencyCounts counts(node);
 
     // If the dependencies are all right inside, just use the root node as the dependency base.
     // This looks hacky but accommodates both _nested_ dependencies for plugins, and extremely simple ones for step
     // visibility.
-    if (node.child("dependencies") && !node.child("fileDependency") && !node.child("flagDependency")
-        && !node.child("gameDependency")) {
-        possibleNode = node.child("dependencies");
+    if (counts.nested > 0 && counts.file == 0 && counts.flag == 0 && counts.game == 0) {
+        possibleNode = counts.firstNested;
+        counts       = DependencyCounts(possibleNode);
     }
 
-    deserializeList(possibleNode, "fileDependency", fileDependencies);
-    deserializeList(possibleNode, "flagDependency", flagDependencies);
-    deserializeList(possibleNode, "gameDependency", gameDependencies);
-    deserializeList(possibleNode, "dependencies", nestedDependencies);
+    // One pass over the children, in document order within each kind
+    fileDependencies.reserve(counts.file);
+    flagDependencies.reserve(counts.flag);
+    gameDependencies.reserve(counts.game);
+    nestedDependencies.reserve(counts.nested);
+    for (pugi::xml_node child : possibleNode.children()) {
+        const char* name = child.name();
+        if (strcmp(name, "fileDependency") == 0) {
+            fileDependencies.emplace_back().deserialize(child);
+        } else if (strcmp(name, "flagDependency") == 0) {
+            flagDependencies.emplace_back().deserialize(child);
+        } else if (strcmp(name, "gameDependency") == 0) {
+            gameDependencies.emplace_back().deserialize(child);
+        } else if (strcmp(name, "dependencies") == 0) {
+            nestedDependencies.emplace_back().deserialize(child);
+        }
+    }
 
     operatorType = OperatorTypeEnum::AND; // safest default.
 
@@ -163,13 +211,16 @@ bool HeaderImage::deserialize(pugi::xml_node& node)
     return true;
 }
 
-bool FileList::deserialize(pugi::xml_node& node)
+bool FileList::deserialize(pugi::xml_node& node, const ParseProfile profile)
 {
-    for (pugi::xml_node childNode : node.children()) {
-        if (std::string(childNode.name()) == "folder" || std::string(childNode.name()) == "file") {
-            File file;
-            file.deserialize(childNode);
-            files.emplace_back(file);
+    const auto isFileOrFolder = [](const pugi::xml_node& child) {
+        return strcmp(child.name(), "folder") == 0 || strcmp(child.name(), "file") == 0;
+    };
+    const auto children = node.children();
+    files.reserve(files.size() + std::count_if(children.begin(), children.end(), isFileOrFolder));
+    for (pugi::xml_node childNode : children) {
+        if (isFileOrFolder(childNode)) {
+            files.emplace_back().deserialize(childNode, profile);
         }
     }
     return true;
@@ -196,12 +247,15 @@ bool ConditionFlag::deserialize(pugi::xml_node& node)
 
 bool ConditionFlagList::deserialize(pugi::xml_node& node) { return deserializeList(node, "flag", flags); }
 
-bool File::deserialize(pugi::xml_node& node)
+bool File::deserialize(pugi::xml_node& node, const ParseProfile profile)
 {
     source = node.attribute("source").as_string();
     // destination = node.attribute("destination").as_string();
     priority = node.attribute("priority").as_int();
     isFolder = strcmp(node.name(), "folder") == 0;
+    if (profile == ParseProfile::IndexOnly) {
+        return true;
+    }
     if (auto attr = node.attribute("destination"); attr) {
         destination = attr.as_string();
     } else {
@@ -210,32 +264,37 @@ bool File::deserialize(pugi::xml_node& node)
     return true;
 }
 
-bool Plugin::deserialize(pugi::xml_node& node)
+bool Plugin::deserialize(pugi::xml_node& node, const ParseProfile profile)
 {
-    pugi::xml_node imageNode          = node.child("image");
     pugi::xml_node typeDescriptorNode = node.child("typeDescriptor");
-    pugi::xml_node conditionFlagsNode = node.child("conditionFlags");
     pugi::xml_node filesNode          = node.child("files");
 
+    typeDescriptor.deserialize(typeDescriptorNode);
+    name = node.attribute("name").as_string();
+    trim(name);
+    files.deserialize(filesNode, profile);
+    if (profile == ParseProfile::IndexOnly) {
+        return true;
+    }
+
+    pugi::xml_node imageNode          = node.child("image");
+    pugi::xml_node conditionFlagsNode = node.child("conditionFlags");
+
     // Description is optional in the schema; guard against null C strings from pugixml.
     if (const pugi::xml_node descNode = node.child("description")) {
         if (const char* rawDesc = descNode.text().as_string()) {
             description = rawDesc;
         }
     }
-    description = trim(description); // Find a better way to do this eventually.
+    trim(description);
     image.deserialize(imageNode);
-    typeDescriptor.deserialize(typeDescriptorNode);
-    name = node.attribute("name").as_string();
-    name = trim(name);
     conditionFlags.deserialize(conditionFlagsNode);
-    files.deserialize(filesNode);
     return true;
 }
 
-bool PluginList::deserialize(pugi::xml_node& node)
+bool PluginList::deserialize(pugi::xml_node& node, const ParseProfile profile)
 {
-    deserializeList(node, "plugin", plugins);
+    deserializeList(node, "plugin", plugins, profile);
     order = XmlHelper::getOrderType(node.attribute("order").as_string(), OrderTypeEnum::Ascending);
 
     // Sort the plugins based on the specified order
@@ -252,18 +311,18 @@ bool PluginList::deserialize(pugi::xml_node& node)
     return true;
 }
 
-bool Group::deserialize(pugi::xml_node& node)
+bool Group::deserialize(pugi::xml_node& node, const ParseProfile profile)
 {
     pugi::xml_node pluginsNode = node.child("plugins");
-    plugins.deserialize(pluginsNode);
+    plugins.deserialize(pluginsNode, profile);
     name = node.attribute("name").as_string();
     type = groupTypeFromString(node.attribute("type").as_string());
     return true;
 }
 
-bool GroupList::deserialize(pugi::xml_node& node)
+bool GroupList::deserialize(pugi::xml_node& node, const ParseProfile profile)
 {
-    deserializeList(node, "group", groups);
+    deserializeList(node, "group", groups, profile);
     order = XmlHelper::getOrderType(node.attribute("order").as_string());
 
     // Sort the groups based on the specified order
@@ -279,12 +338,14 @@ bool GroupList::deserialize(pugi::xml_node& node)
     return true;
 }
 
-bool InstallStep::deserialize(pugi::xml_node& node)
+bool InstallStep::deserialize(pugi::xml_node& node, const ParseProfile profile)
 {
-    pugi::xml_node visibleNode            = node.child("visible");
     pugi::xml_node optionalFileGroupsNode = node.child("optionalFileGroups");
-    visible.deserialize(visibleNode);
-    optionalFileGroups.deserialize(optionalFileGroupsNode);
+    if (profile == ParseProfile::Full) {
+        pugi::xml_node visibleNode = node.child("visible");
+        visible.deserialize(visibleNode);
+    }
+    optionalFileGroups.deserialize(optionalFileGroupsNode, profile);
     name = node.attribute("name").as_string();
     return true;
 }
@@ -296,33 +357,51 @@ bool ConditionalFileInstall::deserialize(pugi::xml_node& node)
     return true;
 }
 
-bool StepList::deserialize(pugi::xml_node& node)
+bool StepList::deserialize(pugi::xml_node& node, const ParseProfile profile)
 {
-    deserializeList(node, "installStep", installSteps);
+    deserializeList(node, "installStep", installSteps, profile);
     order = XmlHelper::getOrderType(node.attribute("order").as_string());
     return true;
 }
 
-bool ModuleConfiguration::deserialize(const QString& filePath)
+bool ModuleConfiguration::deserialize(const QString& filePath, const ParseProfile profile)
 {
-    pugi::xml_document doc_;
-
-    const auto& path = filePath;
+    pugi::xml_document doc;
 
-    if (const pugi::xml_parse_result result = doc_.load_file(path.toStdWString().c_str()); !result) {
+    if (const pugi::xml_parse_result result = doc.load_file(filePath.toStdWString().c_str()); !result) {
         throw XmlParseException(std::format("XML parsed with errors: {}", result.description()));
     }
 
+    return deserializeDocument(doc, profile);
+}
+
+bool ModuleConfiguration::deserialize(const std::span<const char> buffer, const ParseProfile profile)
+{
     pugi::xml_document doc;
-    doc.reset(doc_);
 
-    const pugi::xml_node configNode = doc_.child("config");
+    // pugixml detects the encoding (including UTF-16 with a BOM) from the buffer, the same as load_file does.
+    if (const pugi::xml_parse_result result = doc.load_buffer(buffer.data(), buffer.size()); !result) {
+        throw XmlParseException(std::format("XML parsed with errors: {}", result.description()));
+    }
+
+    return deserializeDocument(doc, profile);
+}
+
+bool ModuleConfiguration::deserializeDocument(const pugi::xml_document& doc, const ParseProfile profile)
+{
+    const pugi::xml_node configNode = doc.child("config");
     if (!configNode) {
         throw XmlParseException("No <config> node found");
     }
 
     moduleName = configNode.child("moduleName").text().as_string();
 
+    pugi::xml_node installStepsNode = configNode.child("installSteps");
+    installSteps.deserialize(installStepsNode, profile);
+    if (profile == ParseProfile::IndexOnly) {
+        return true;
+    }
+
     moduleImage                    = HeaderImage();
     pugi::xml_node moduleImageNode = configNode.child("moduleImage");
     moduleImage.deserialize(moduleImageNode);
@@ -333,9 +412,6 @@ bool ModuleConfiguration::deserialize(const QString& filePath)
     pugi::xml_node requiredInstallFilesNode = configNode.child("requiredInstallFiles");
     requiredInstallFiles.deserialize(requiredInstallFilesNode);
 
-    pugi::xml_node installStepsNode = configNode.child("installSteps");
-    installSteps.deserialize(installStepsNode);
-
     pugi::xml_node conditionalFileInstallsNode = configNode.child("conditionalFileInstalls");
     conditionalFileInstalls.deserialize(conditionalFileInstallsNode);
 
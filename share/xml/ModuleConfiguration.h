@@ -4,6 +4,7 @@
 #include <optional>
 #include <pugixml.hpp>
 #include <qstring.h>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -25,6 +26,15 @@ enum class OrderTypeEnum { Explicit, Ascending, Descending };
 
 enum class FileDependencyTypeEnum { Missing, Inactive, Active, UNKNOWN_STATE };
 
+/**
+ * How much of a ModuleConfig.xml to materialize.
+ * Full: everything, as the installer needs it.
+ * IndexOnly: what indexing a FOMOD needs (FomodDB::getEntryFromFomod): module name, step, group and plugin names,
+ * plugin type descriptors, and file sources. Descriptions, images, condition flags, step visibility, file
+ * destinations, module dependencies, required files and conditional installs are left empty.
+ */
+enum class ParseProfile { Full, IndexOnly };
+
 template <typename T> class OrderedContents {
   public:
     OrderTypeEnum order;
@@ -159,9 +169,9 @@ class Image final : public XmlDeserializable {
 class HeaderImage final : public XmlDeserializable {
   public:
     std::string path;
-    bool showImage;
-    bool showFade;
-    int height;
+    bool showImage { false };
+    bool showFade { false };
+    int height { 0 };
 
     bool deserialize(pugi::xml_node& node) override;
 };
@@ -171,16 +181,18 @@ class File final : public XmlDeserializable {
     std::string source;
     std::optional<std::string> destination;
     int priority { 0 };
-    bool isFolder;
+    bool isFolder { false };
 
-    bool deserialize(pugi::xml_node& node) override;
+    bool deserialize(pugi::xml_node& node) override { return deserialize(node, ParseProfile::Full); }
+    bool deserialize(pugi::xml_node& node, ParseProfile profile);
 };
 
 class FileList final : public XmlDeserializable {
   public:
     std::vector<File> files;
 
-    bool deserialize(pugi::xml_node& node) override;
+    bool deserialize(pugi::xml_node& node) override { return deserialize(node, ParseProfile::Full); }
+    bool deserialize(pugi::xml_node& node, ParseProfile profile);
 };
 
 class ConditionalFileInstallPattern final : public XmlDeserializable {
@@ -216,7 +228,8 @@ class Plugin final : public XmlDeserializable {
     ConditionFlagList conditionFlags;
     FileList files;
 
-    bool deserialize(pugi::xml_node& node) override;
+    bool deserialize(pugi::xml_node& node) override { return deserialize(node, ParseProfile::Full); }
+    bool deserialize(pugi::xml_node& node, ParseProfile profile);
 };
 
 class PluginList final : public XmlDeserializable, public OrderedContents<Plugin> {
@@ -224,7 +237,8 @@ class PluginList final : public XmlDeserializable, public OrderedContents<Plugin
     std::vector<Plugin> plugins;
     OrderTypeEnum order;
 
-    bool deserialize(pugi::xml_node& node) override;
+    bool deserialize(pugi::xml_node& node) override { return deserialize(node, ParseProfile::Full); }
+    bool deserialize(pugi::xml_node& node, ParseProfile profile);
 };
 
 class Group final : public XmlDeserializable {
@@ -233,7 +247,8 @@ class Group final : public XmlDeserializable {
     std::string name;
     GroupTypeEnum type;
 
-    bool deserialize(pugi::xml_node& node) override;
+    bool deserialize(pugi::xml_node& node) override { return deserialize(node, ParseProfile::Full); }
+    bool deserialize(pugi::xml_node& node, ParseProfile profile);
 };
 
 class GroupList final : public XmlDeserializable, public OrderedContents<Group> {
@@ -241,7 +256,8 @@ class GroupList final : public XmlDeserializable, public OrderedContents<Group>
     std::vector<Group> groups;
     OrderTypeEnum order;
 
-    bool deserialize(pugi::xml_node& node) override;
+    bool deserialize(pugi::xml_node& node) override { return deserialize(node, ParseProfile::Full); }
+    bool deserialize(pugi::xml_node& node, ParseProfile profile);
 };
 
 class InstallStep final : public XmlDeserializable {
@@ -250,7 +266,8 @@ class InstallStep final : public XmlDeserializable {
     GroupList optionalFileGroups;
     std::string name;
 
-    bool deserialize(pugi::xml_node& node) override;
+    bool deserialize(pugi::xml_node& node) override { return deserialize(node, ParseProfile::Full); }
+    bool deserialize(pugi::xml_node& node, ParseProfile profile);
 };
 
 class ConditionalFileInstall final : public XmlDeserializable {
@@ -265,7 +282,8 @@ class StepList final : public XmlDeserializable, public OrderedContents<InstallS
     std::vector<InstallStep> installSteps;
     OrderTypeEnum order;
 
-    bool deserialize(pugi::xml_node& node) override;
+    bool deserialize(pugi::xml_node& node) override { return deserialize(node, ParseProfile::Full); }
+    bool deserialize(pugi::xml_node& node, ParseProfile profile);
 };
 
 class ModuleConfiguration {
@@ -277,5 +295,14 @@ class ModuleConfiguration {
     StepList installSteps;
     ConditionalFileInstall conditionalFileInstalls;
 
-    bool deserialize(const QString& filePath);
+    bool deserialize(const QString& filePath, ParseProfile profile = ParseProfile::Full);
+
+    /**
+     * Parse a ModuleConfig.xml that is already in memory (e.g. from ArchiveExtractor::extractFomodDataToMemory).
+     * Throws XmlParseException like the file-based overload.
+     */
+    bool deserialize(std::span<const char> buffer, ParseProfile profile = ParseProfile::Full);
+
+  private:
+    bool deserializeDocument(const pugi::xml_document& doc, ParseProfile profile);
 };
\ No newline at end of file
@@ -0,0 +1,92 @@
+// Parse-time benchmark for ModuleConfiguration over the tests/moduleconf fixtures. Not part of runTests; build the
+// benchmarkModuleConf target (in Release) on two revisions to compare them.
+//
+// Usage: benchmarkModuleConf [iterations]
+
+#include "xml/ModuleConfiguration.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <pugixml.hpp>
+#include <string>
+#include <vector>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Timing {
+    double meanUs = 0;
+    double minUs  = 0;
+};
+
+template <typename Fn> Timing measure(const int iterations, Fn&& fn)
+{
+    fn(); // Warm up
+    double total = 0;
+    double best  = 0;
+    for (int i = 0; i < iterations; ++i) {
+        const auto start = Clock::now();
+        fn();
+        const double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        total += us;
+        best = i == 0 ? us : std::min(best, us);
+    }
+    return { total / iterations, best };
+}
+
+std::vector<char> readFile(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return { std::istreambuf_iterator(file), std::istreambuf_iterator<char>() };
+}
+}
+
+int main(const int argc, char* argv[])
+{
+    const int iterations = argc > 1 ? std::max(1, std::stoi(argv[1])) : 200;
+    const auto fixtures  = std::filesystem::path(__FILE__).parent_path() / "moduleconf";
+
+    std::vector<std::filesystem::path> files;
+    for (const auto& entry : std::filesystem::directory_iterator(fixtures)) {
+        if (entry.path().extension() == ".xml") {
+            files.push_back(entry.path());
+        }
+    }
+    std::ranges::sort(files);
+
+    // "DOM" is pugixml alone; "model" is what a Full deserialize() adds on top of it
+    std::printf("%-32s %10s %12s %12s %12s %12s %12s\n", "fixture", "bytes", "parse mean", "parse min", "index mean",
+        "DOM mean", "model mean");
+    double totalParse = 0;
+    double totalIndex = 0;
+    double totalDom   = 0;
+    for (const auto& path : files) {
+        const auto buffer = readFile(path);
+
+        const auto parse = measure(iterations, [&buffer] {
+            ModuleConfiguration config;
+            config.deserialize(std::span<const char>(buffer));
+        });
+        const auto index = measure(iterations, [&buffer] {
+            ModuleConfiguration config;
+            config.deserialize(std::span<const char>(buffer), ParseProfile::IndexOnly);
+        });
+        const auto dom   = measure(iterations, [&buffer] {
+            pugi::xml_document doc;
+            doc.load_buffer(buffer.data(), buffer.size());
+        });
+
+        std::printf("%-32s %10zu %10.1fus %10.1fus %10.1fus %10.1fus %10.1fus\n", path.filename().string().c_str(),
+            buffer.size(), parse.meanUs, parse.minUs, index.meanUs, dom.meanUs, parse.meanUs - dom.meanUs);
+        totalParse += parse.meanUs;
+        totalIndex += index.meanUs;
+        totalDom += dom.meanUs;
+    }
+    std::printf("%-32s %10s %10.1fus %12s %10.1fus %10.1fus %10.1fus\n", "total", "", totalParse, "", totalIndex,
+        totalDom, totalParse - totalDom);
+    return 0;
+}
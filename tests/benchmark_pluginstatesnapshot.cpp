@@ -0,0 +1,99 @@
+// Condition evaluation benchmark comparing PluginStateSnapshot with the string-keyed makeCachedResolver it replaced
+// in the Patch Finder. Not part of runTests; build the benchmarkPluginStateSnapshot target (in Release) to run it.
+//
+// Usage: benchmarkPluginStateSnapshot [iterations]
+
+#include "FOMODData/ConditionEvaluator.h"
+#include "FOMODData/PluginStateSnapshot.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+constexpr int PLUGIN_COUNT = 2000;
+constexpr int OPTION_COUNT = 5000;
+
+struct Timing {
+    double meanUs = 0;
+    double minUs  = 0;
+};
+
+template <typename Fn> Timing measure(const int iterations, Fn&& fn)
+{
+    fn(); // Warm up
+    double total = 0;
+    double best  = 0;
+    for (int i = 0; i < iterations; ++i) {
+        const auto start = Clock::now();
+        fn();
+        const double us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        total += us;
+        best = i == 0 ? us : std::min(best, us);
+    }
+    return { total / iterations, best };
+}
+
+// A synthetic DB whose options each test a handful of the load order's plugins
+std::vector<FomodOption> makeOptions()
+{
+    std::vector<FomodOption> options;
+    options.reserve(OPTION_COUNT);
+    for (int i = 0; i < OPTION_COUNT; ++i) {
+        StoredTypePattern pattern;
+        pattern.type                      = StoredPluginType::Recommended;
+        pattern.dependencies.operatorType = i % 2 == 0 ? StoredOperator::And : StoredOperator::Or;
+        for (int d = 0; d < 4; ++d) {
+            // Every few options reference a plugin that isn't in the load order
+            const auto index = (i * 7 + d * 13) % (PLUGIN_COUNT + 100);
+            pattern.dependencies.fileDependencies.push_back(
+                { "Plugin" + std::to_string(index) + ".esp", StoredFileState::Active });
+        }
+        options.emplace_back("Option", "patch.esp", std::vector<StringId> {}, "Step", "Group",
+            SelectionState::Unknown, std::vector { pattern });
+    }
+    return options;
+}
+}
+
+int main(const int argc, char* argv[])
+{
+    const int iterations = argc > 1 ? std::max(1, std::stoi(argv[1])) : 50;
+
+    std::unordered_map<std::string, StoredFileState> loadOrder;
+    PluginStateSnapshot snapshot;
+    for (int i = 0; i < PLUGIN_COUNT; ++i) {
+        const auto name  = "Plugin" + std::to_string(i) + ".esp";
+        const auto state = i % 3 == 0 ? StoredFileState::Inactive : StoredFileState::Active;
+        loadOrder[name]  = state;
+        snapshot.set(name, state);
+    }
+    const auto options = makeOptions();
+
+    // Built once and reused, as the Patch Finder did; the warm-up pass fills its cache
+    const auto resolver = makeCachedResolver([&loadOrder](const std::string& fileName) {
+        const auto it = loadOrder.find(fileName);
+        return it != loadOrder.end() ? it->second : StoredFileState::Missing;
+    });
+    const auto cached = measure(iterations, [&] {
+        for (const auto& option : options) {
+            ConditionEvaluator::resolveMatchingType(option, resolver);
+        }
+    });
+    const auto snapshotted = measure(iterations, [&] {
+        for (const auto& option : options) {
+            ConditionEvaluator::resolveMatchingType(option, snapshot);
+        }
+    });
+
+    std::printf("%d options over %d plugins, %d iterations\n", OPTION_COUNT, PLUGIN_COUNT, iterations);
+    std::printf("%-16s %12s %12s\n", "resolver", "mean", "min");
+    std::printf("%-16s %10.1fus %10.1fus\n", "cached", cached.meanUs, cached.minUs);
+    std::printf("%-16s %10.1fus %10.1fus\n", "snapshot", snapshotted.meanUs, snapshotted.minUs);
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include "FOMODData/ArchiveMetadataCache.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+
+class ArchiveMetadataCacheTest : public ::testing::Test {
+  protected:
+    std::string tempDir;
+    std::string cachePath;
+    QString archivePath;
+
+    void SetUp() override
+    {
+        tempDir = std::filesystem::temp_directory_path().string() + "/fomod_archive_cache_test_"
+            + std::to_string(std::rand());
+        std::filesystem::create_directory(tempDir);
+        cachePath   = tempDir + "/" + ARCHIVE_CACHE_FILE;
+        archivePath = QString::fromStdString(tempDir + "/Lux.7z");
+        writeArchive("original contents");
+    }
+
+    void TearDown() override { std::filesystem::remove_all(tempDir); }
+
+    void writeArchive(const std::string& contents) const
+    {
+        std::ofstream archive(archivePath.toStdString(), std::ios::binary | std::ios::trunc);
+        archive << contents;
+    }
+
+    static std::shared_ptr<FomodDbEntry> makeEntry()
+    {
+        std::vector<FomodOption> options = { FomodOption("Patch", "patches/Lux - Patch.esp",
+            { "Skyrim.esm", "Lux.esp" }, "Step", "Group") };
+        return std::make_shared<FomodDbEntry>(1234, "Lux", options);
+    }
+};
+
+TEST_F(ArchiveMetadataCacheTest, PersistsParsedEntries)
+{
+    {
+        ArchiveMetadataCache cache(cachePath);
+        EXPECT_FALSE(cache.find(archivePath).has_value());
+        cache.storeParsed(archivePath, makeEntry());
+        ASSERT_TRUE(cache.save());
+    }
+
+    const ArchiveMetadataCache reloaded(cachePath);
+    const auto cached = reloaded.find(archivePath);
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_TRUE(cached->hasFomod);
+    EXPECT_TRUE(cached->parsed);
+    ASSERT_NE(cached->entry, nullptr);
+    EXPECT_EQ("Lux", cached->entry->getDisplayName());
+    ASSERT_EQ(1, cached->entry->getOptions().size());
+    EXPECT_EQ(cached->entry->getOptions()[0].masters, (std::vector<StringId> { "Skyrim.esm", "Lux.esp" }));
+}
+
+TEST_F(ArchiveMetadataCacheTest, ChangedArchiveIsAMiss)
+{
+    ArchiveMetadataCache cache(cachePath);
+    cache.storeHasFomod(archivePath, true);
+    ASSERT_TRUE(cache.find(archivePath).has_value());
+
+    writeArchive("a different, longer set of contents");
+    EXPECT_FALSE(cache.find(archivePath).has_value());
+}
+
+TEST_F(ArchiveMetadataCacheTest, FlagDoesNotReplaceParsedRecord)
+{
+    ArchiveMetadataCache cache(cachePath);
+    cache.storeParsed(archivePath, nullptr); // Parsed, but no options
+    cache.storeHasFomod(archivePath, true);
+
+    const auto cached = cache.find(archivePath);
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_TRUE(cached->parsed);
+    EXPECT_EQ(cached->entry, nullptr);
+}
+
+TEST_F(ArchiveMetadataCacheTest, CorruptFileStartsEmpty)
+{
+    {
+        ArchiveMetadataCache cache(cachePath);
+        cache.storeHasFomod(archivePath, false);
+        ASSERT_TRUE(cache.save());
+    }
+    {
+        std::fstream file(cachePath, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-1, std::ios::end);
+        file.put('\x7f');
+    }
+
+    const ArchiveMetadataCache reloaded(cachePath);
+    EXPECT_EQ(0, reloaded.size());
+}
+
+TEST_F(ArchiveMetadataCacheTest, SaveDropsDeletedArchives)
+{
+    ArchiveMetadataCache cache(cachePath);
+    cache.storeHasFomod(archivePath, true);
+    std::filesystem::remove(archivePath.toStdString());
+    ASSERT_TRUE(cache.save());
+
+    const ArchiveMetadataCache reloaded(cachePath);
+    EXPECT_EQ(0, reloaded.size());
+}
@@ -3,13 +3,13 @@
 #include <gtest/gtest.h>
 
 // Helper: create a mock resolver from a map
-PluginStateResolver makeResolver(const std::unordered_map<std::string, std::string>& states)
+PluginStateResolver makeResolver(const std::unordered_map<std::string, StoredFileState>& states)
 {
-    return [states](const std::string& fileName) -> std::string {
+    return [states](const std::string& fileName) -> StoredFileState {
         if (auto it = states.find(fileName); it != states.end()) {
             return it->second;
         }
-        return "Missing";
+        return StoredFileState::Missing;
     };
 }
 
@@ -17,36 +17,36 @@ PluginStateResolver makeResolver(const std::unordered_map<std::string, std::stri
 
 TEST(ConditionEvaluatorTest, FileDependencyActive)
 {
-    StoredFileDependency dep { "AOS.esp", "Active" };
-    auto resolver = makeResolver({ { "AOS.esp", "Active" } });
+    StoredFileDependency dep { "AOS.esp", StoredFileState::Active };
+    auto resolver = makeResolver({ { "AOS.esp", StoredFileState::Active } });
     EXPECT_TRUE(ConditionEvaluator::evaluateFileDependency(dep, resolver));
 }
 
 TEST(ConditionEvaluatorTest, FileDependencyInactive)
 {
-    StoredFileDependency dep { "AOS.esp", "Active" };
-    auto resolver = makeResolver({ { "AOS.esp", "Inactive" } });
+    StoredFileDependency dep { "AOS.esp", StoredFileState::Active };
+    auto resolver = makeResolver({ { "AOS.esp", StoredFileState::Inactive } });
     EXPECT_FALSE(ConditionEvaluator::evaluateFileDependency(dep, resolver));
 }
 
 TEST(ConditionEvaluatorTest, FileDependencyMissing)
 {
-    StoredFileDependency dep { "AOS.esp", "Active" };
+    StoredFileDependency dep { "AOS.esp", StoredFileState::Active };
     auto resolver = makeResolver({}); // Not in map → "Missing"
     EXPECT_FALSE(ConditionEvaluator::evaluateFileDependency(dep, resolver));
 }
 
 TEST(ConditionEvaluatorTest, FileDependencyCheckMissing)
 {
-    StoredFileDependency dep { "AOS.esp", "Missing" };
+    StoredFileDependency dep { "AOS.esp", StoredFileState::Missing };
     auto resolver = makeResolver({}); // Not in map → "Missing"
     EXPECT_TRUE(ConditionEvaluator::evaluateFileDependency(dep, resolver));
 }
 
 TEST(ConditionEvaluatorTest, FileDependencyCheckInactive)
 {
-    StoredFileDependency dep { "AOS.esp", "Inactive" };
-    auto resolver = makeResolver({ { "AOS.esp", "Inactive" } });
+    StoredFileDependency dep { "AOS.esp", StoredFileState::Inactive };
+    auto resolver = makeResolver({ { "AOS.esp", StoredFileState::Inactive } });
     EXPECT_TRUE(ConditionEvaluator::evaluateFileDependency(dep, resolver));
 }
 
@@ -55,42 +55,42 @@ TEST(ConditionEvaluatorTest, FileDependencyCheckInactive)
 TEST(ConditionEvaluatorTest, AndOperatorAllTrue)
 {
     StoredDependencies deps;
-    deps.operatorType = "And";
-    deps.fileDependencies.push_back({ "A.esp", "Active" });
-    deps.fileDependencies.push_back({ "B.esp", "Active" });
+    deps.operatorType = StoredOperator::And;
+    deps.fileDependencies.push_back({ "A.esp", StoredFileState::Active });
+    deps.fileDependencies.push_back({ "B.esp", StoredFileState::Active });
 
-    auto resolver = makeResolver({ { "A.esp", "Active" }, { "B.esp", "Active" } });
+    auto resolver = makeResolver({ { "A.esp", StoredFileState::Active }, { "B.esp", StoredFileState::Active } });
     EXPECT_TRUE(ConditionEvaluator::evaluateDependencies(deps, resolver));
 }
 
 TEST(ConditionEvaluatorTest, AndOperatorOneFalse)
 {
     StoredDependencies deps;
-    deps.operatorType = "And";
-    deps.fileDependencies.push_back({ "A.esp", "Active" });
-    deps.fileDependencies.push_back({ "B.esp", "Active" });
+    deps.operatorType = StoredOperator::And;
+    deps.fileDependencies.push_back({ "A.esp", StoredFileState::Active });
+    deps.fileDependencies.push_back({ "B.esp", StoredFileState::Active });
 
-    auto resolver = makeResolver({ { "A.esp", "Active" }, { "B.esp", "Missing" } });
+    auto resolver = makeResolver({ { "A.esp", StoredFileState::Active }, { "B.esp", StoredFileState::Missing } });
     EXPECT_FALSE(ConditionEvaluator::evaluateDependencies(deps, resolver));
 }
 
 TEST(ConditionEvaluatorTest, OrOperatorOneTrue)
 {
     StoredDependencies deps;
-    deps.operatorType = "Or";
-    deps.fileDependencies.push_back({ "A.esp", "Active" });
-    deps.fileDependencies.push_back({ "B.esp", "Active" });
+    deps.operatorType = StoredOperator::Or;
+    deps.fileDependencies.push_back({ "A.esp", StoredFileState::Active });
+    deps.fileDependencies.push_back({ "B.esp", StoredFileState::Active });
 
-    auto resolver = makeResolver({ { "A.esp", "Missing" }, { "B.esp", "Active" } });
+    auto resolver = makeResolver({ { "A.esp", StoredFileState::Missing }, { "B.esp", StoredFileState::Active } });
     EXPECT_TRUE(ConditionEvaluator::evaluateDependencies(deps, resolver));
 }
 
 TEST(ConditionEvaluatorTest, OrOperatorNoneTrue)
 {
     StoredDependencies deps;
-    deps.operatorType = "Or";
-    deps.fileDependencies.push_back({ "A.esp", "Active" });
-    deps.fileDependencies.push_back({ "B.esp", "Active" });
+    deps.operatorType = StoredOperator::Or;
+    deps.fileDependencies.push_back({ "A.esp", StoredFileState::Active });
+    deps.fileDependencies.push_back({ "B.esp", StoredFileState::Active });
 
     auto resolver = makeResolver({}); // Both missing
     EXPECT_FALSE(ConditionEvaluator::evaluateDependencies(deps, resolver));
@@ -102,21 +102,21 @@ TEST(ConditionEvaluatorTest, NestedDependencies)
 {
     // AND(A=Active, OR(B=Active, C=Active))
     StoredDependencies inner;
-    inner.operatorType = "Or";
-    inner.fileDependencies.push_back({ "B.esp", "Active" });
-    inner.fileDependencies.push_back({ "C.esp", "Active" });
+    inner.operatorType = StoredOperator::Or;
+    inner.fileDependencies.push_back({ "B.esp", StoredFileState::Active });
+    inner.fileDependencies.push_back({ "C.esp", StoredFileState::Active });
 
     StoredDependencies deps;
-    deps.operatorType = "And";
-    deps.fileDependencies.push_back({ "A.esp", "Active" });
+    deps.operatorType = StoredOperator::And;
+    deps.fileDependencies.push_back({ "A.esp", StoredFileState::Active });
     deps.nestedDependencies.push_back(inner);
 
     // A active, B missing, C active → AND(true, OR(false, true)) → true
-    auto resolver = makeResolver({ { "A.esp", "Active" }, { "C.esp", "Active" } });
+    auto resolver = makeResolver({ { "A.esp", StoredFileState::Active }, { "C.esp", StoredFileState::Active } });
     EXPECT_TRUE(ConditionEvaluator::evaluateDependencies(deps, resolver));
 
     // A active, B missing, C missing → AND(true, OR(false, false)) → false
-    auto resolver2 = makeResolver({ { "A.esp", "Active" } });
+    auto resolver2 = makeResolver({ { "A.esp", StoredFileState::Active } });
     EXPECT_FALSE(ConditionEvaluator::evaluateDependencies(deps, resolver2));
 }
 
@@ -125,7 +125,7 @@ TEST(ConditionEvaluatorTest, NestedDependencies)
 TEST(ConditionEvaluatorTest, FlagOnlyReturnsFalse)
 {
     StoredDependencies deps;
-    deps.operatorType = "And";
+    deps.operatorType = StoredOperator::And;
     deps.flagDependencies.push_back({ "MyFlag", "On" });
     // No file dependencies → no evaluable conditions → false
 
@@ -138,11 +138,11 @@ TEST(ConditionEvaluatorTest, MixedFileAndFlagSkipsFlags)
     // AND operator with file dep (true) and flag dep (skipped)
     // Only file dep contributes → result is true
     StoredDependencies deps;
-    deps.operatorType = "And";
-    deps.fileDependencies.push_back({ "A.esp", "Active" });
+    deps.operatorType = StoredOperator::And;
+    deps.fileDependencies.push_back({ "A.esp", StoredFileState::Active });
     deps.flagDependencies.push_back({ "MyFlag", "On" });
 
-    auto resolver = makeResolver({ { "A.esp", "Active" } });
+    auto resolver = makeResolver({ { "A.esp", StoredFileState::Active } });
     EXPECT_TRUE(ConditionEvaluator::evaluateDependencies(deps, resolver));
 }
 
@@ -152,7 +152,7 @@ TEST(ConditionEvaluatorTest, EmptyDependenciesReturnsFalse)
 {
     // Empty deps with no flags → evaluateDependencies returns false (no signal)
     StoredDependencies deps;
-    deps.operatorType = "And";
+    deps.operatorType = StoredOperator::And;
 
     auto resolver = makeResolver({});
     EXPECT_FALSE(ConditionEvaluator::evaluateDependencies(deps, resolver));
@@ -163,98 +163,98 @@ TEST(ConditionEvaluatorTest, EmptyDependenciesReturnsFalse)
 TEST(ConditionEvaluatorTest, ResolveMatchingTypeFirstMatch)
 {
     StoredTypePattern p1;
-    p1.type                 = "Recommended";
-    p1.dependencies.operatorType = "And";
-    p1.dependencies.fileDependencies.push_back({ "AOS.esp", "Active" });
+    p1.type                 = StoredPluginType::Recommended;
+    p1.dependencies.operatorType = StoredOperator::And;
+    p1.dependencies.fileDependencies.push_back({ "AOS.esp", StoredFileState::Active });
 
-    auto resolver = makeResolver({ { "AOS.esp", "Active" } });
+    auto resolver = makeResolver({ { "AOS.esp", StoredFileState::Active } });
     auto result   = ConditionEvaluator::resolveMatchingType({ p1 }, resolver);
-    EXPECT_EQ(result, "Recommended");
+    EXPECT_EQ(result, StoredPluginType::Recommended);
 }
 
 TEST(ConditionEvaluatorTest, ResolveMatchingTypeNoMatch)
 {
     StoredTypePattern p1;
-    p1.type                 = "Recommended";
-    p1.dependencies.operatorType = "And";
-    p1.dependencies.fileDependencies.push_back({ "AOS.esp", "Active" });
+    p1.type                 = StoredPluginType::Recommended;
+    p1.dependencies.operatorType = StoredOperator::And;
+    p1.dependencies.fileDependencies.push_back({ "AOS.esp", StoredFileState::Active });
 
     auto resolver = makeResolver({}); // AOS not present
     auto result   = ConditionEvaluator::resolveMatchingType({ p1 }, resolver);
-    EXPECT_EQ(result, "");
+    EXPECT_FALSE(result.has_value());
 }
 
 TEST(ConditionEvaluatorTest, ResolveMatchingTypeFirstMatchSemantics)
 {
     // Pattern 1: NotUsable if AOS active
     StoredTypePattern p1;
-    p1.type                 = "NotUsable";
-    p1.dependencies.operatorType = "And";
-    p1.dependencies.fileDependencies.push_back({ "AOS.esp", "Active" });
+    p1.type                 = StoredPluginType::NotUsable;
+    p1.dependencies.operatorType = StoredOperator::And;
+    p1.dependencies.fileDependencies.push_back({ "AOS.esp", StoredFileState::Active });
 
     // Pattern 2: Recommended if ELFX active
     StoredTypePattern p2;
-    p2.type                 = "Recommended";
-    p2.dependencies.operatorType = "And";
-    p2.dependencies.fileDependencies.push_back({ "ELFX.esp", "Active" });
+    p2.type                 = StoredPluginType::Recommended;
+    p2.dependencies.operatorType = StoredOperator::And;
+    p2.dependencies.fileDependencies.push_back({ "ELFX.esp", StoredFileState::Active });
 
     // Both AOS and ELFX active → first match wins → NotUsable
-    auto resolver = makeResolver({ { "AOS.esp", "Active" }, { "ELFX.esp", "Active" } });
+    auto resolver = makeResolver({ { "AOS.esp", StoredFileState::Active }, { "ELFX.esp", StoredFileState::Active } });
     auto result   = ConditionEvaluator::resolveMatchingType({ p1, p2 }, resolver);
-    EXPECT_EQ(result, "NotUsable");
+    EXPECT_EQ(result, StoredPluginType::NotUsable);
 }
 
 TEST(ConditionEvaluatorTest, ResolveMatchingTypeSkipsNonMatchingFirst)
 {
     // Pattern 1: NotUsable if AOS active (won't match)
     StoredTypePattern p1;
-    p1.type                 = "NotUsable";
-    p1.dependencies.operatorType = "And";
-    p1.dependencies.fileDependencies.push_back({ "AOS.esp", "Active" });
+    p1.type                 = StoredPluginType::NotUsable;
+    p1.dependencies.operatorType = StoredOperator::And;
+    p1.dependencies.fileDependencies.push_back({ "AOS.esp", StoredFileState::Active });
 
     // Pattern 2: Recommended if ELFX active (will match)
     StoredTypePattern p2;
-    p2.type                 = "Recommended";
-    p2.dependencies.operatorType = "And";
-    p2.dependencies.fileDependencies.push_back({ "ELFX.esp", "Active" });
+    p2.type                 = StoredPluginType::Recommended;
+    p2.dependencies.operatorType = StoredOperator::And;
+    p2.dependencies.fileDependencies.push_back({ "ELFX.esp", StoredFileState::Active });
 
     // Only ELFX active → first match is p2 → Recommended
-    auto resolver = makeResolver({ { "ELFX.esp", "Active" } });
+    auto resolver = makeResolver({ { "ELFX.esp", StoredFileState::Active } });
     auto result   = ConditionEvaluator::resolveMatchingType({ p1, p2 }, resolver);
-    EXPECT_EQ(result, "Recommended");
+    EXPECT_EQ(result, StoredPluginType::Recommended);
 }
 
 TEST(ConditionEvaluatorTest, ResolveMatchingTypeEmptyDepsStaticFallback)
 {
     // Static fallback: empty dependencies (no flags) → always matches
     StoredTypePattern p1;
-    p1.type                 = "Recommended";
-    p1.dependencies.operatorType = "And";
+    p1.type                 = StoredPluginType::Recommended;
+    p1.dependencies.operatorType = StoredOperator::And;
     // No file deps, no flag deps, no nested deps
 
     auto resolver = makeResolver({});
     auto result   = ConditionEvaluator::resolveMatchingType({ p1 }, resolver);
-    EXPECT_EQ(result, "Recommended");
+    EXPECT_EQ(result, StoredPluginType::Recommended);
 }
 
 TEST(ConditionEvaluatorTest, ResolveMatchingTypeFlagOnlySkipped)
 {
     // Flag-only pattern → skipped (non-evaluable)
     StoredTypePattern p1;
-    p1.type                 = "Recommended";
-    p1.dependencies.operatorType = "And";
+    p1.type                 = StoredPluginType::Recommended;
+    p1.dependencies.operatorType = StoredOperator::And;
     p1.dependencies.flagDependencies.push_back({ "SomeFlag", "On" });
 
     auto resolver = makeResolver({});
     auto result   = ConditionEvaluator::resolveMatchingType({ p1 }, resolver);
-    EXPECT_EQ(result, "");
+    EXPECT_FALSE(result.has_value());
 }
 
 TEST(ConditionEvaluatorTest, ResolveMatchingTypeEmptyPatterns)
 {
     auto resolver = makeResolver({});
     auto result   = ConditionEvaluator::resolveMatchingType({}, resolver);
-    EXPECT_EQ(result, "");
+    EXPECT_FALSE(result.has_value());
 }
 
 // --- makeCachedResolver ---
@@ -262,14 +262,125 @@ TEST(ConditionEvaluatorTest, ResolveMatchingTypeEmptyPatterns)
 TEST(ConditionEvaluatorTest, CachedResolverCachesResults)
 {
     int callCount = 0;
-    auto inner    = [&callCount](const std::string& fileName) -> std::string {
+    auto inner    = [&callCount](const std::string& fileName) -> StoredFileState {
         callCount++;
-        return "Active";
+        return StoredFileState::Active;
     };
 
     auto cached = makeCachedResolver(inner);
-    EXPECT_EQ(cached("test.esp"), "Active");
-    EXPECT_EQ(cached("test.esp"), "Active");
-    EXPECT_EQ(cached("test.esp"), "Active");
+    EXPECT_EQ(cached("test.esp"), StoredFileState::Active);
+    EXPECT_EQ(cached("test.esp"), StoredFileState::Active);
+    EXPECT_EQ(cached("test.esp"), StoredFileState::Active);
     EXPECT_EQ(callCount, 1); // Only called once despite 3 lookups
 }
+
+// --- Compiled condition programs ---
+
+namespace {
+
+FomodOption makeOption(std::vector<StoredTypePattern> patterns)
+{
+    return { "Option", "patch.esp", {}, "Step", "Group", SelectionState::Unknown, std::move(patterns) };
+}
+
+// AND(A=Active, D=Missing, OR(B=Active, C=Inactive))
+StoredTypePattern makeNestedPattern()
+{
+    StoredDependencies inner;
+    inner.operatorType = StoredOperator::Or;
+    inner.fileDependencies.push_back({ "B.esp", StoredFileState::Active });
+    inner.fileDependencies.push_back({ "C.esp", StoredFileState::Inactive });
+
+    StoredTypePattern pattern;
+    pattern.type                      = StoredPluginType::Recommended;
+    pattern.dependencies.operatorType = StoredOperator::And;
+    pattern.dependencies.fileDependencies.push_back({ "A.esp", StoredFileState::Active });
+    pattern.dependencies.fileDependencies.push_back({ "D.esp", StoredFileState::Missing });
+    pattern.dependencies.nestedDependencies.push_back(inner);
+    return pattern;
+}
+
+} // namespace
+
+TEST(ConditionEvaluatorTest, CompiledProgramMatchesTreeEvaluation)
+{
+    constexpr StoredFileState states[]
+        = { StoredFileState::Active, StoredFileState::Inactive, StoredFileState::Missing };
+    const std::vector<std::string> files = { "A.esp", "B.esp", "C.esp", "D.esp" };
+
+    for (const auto op : { StoredOperator::And, StoredOperator::Or }) {
+        auto pattern                      = makeNestedPattern();
+        pattern.dependencies.operatorType = op;
+        const auto program                = ConditionProgram::compile(pattern);
+
+        // Every combination of states for the four files
+        for (int combo = 0; combo < 81; ++combo) {
+            std::unordered_map<std::string, StoredFileState> loadOrder;
+            for (int i = 0, rest = combo; i < 4; ++i, rest /= 3) {
+                loadOrder[files[i]] = states[rest % 3];
+            }
+            const auto resolver = makeResolver(loadOrder);
+            const bool expected = ConditionEvaluator::evaluateDependencies(pattern.dependencies, resolver);
+            EXPECT_EQ(program.evaluate(resolver), expected) << "combo " << combo;
+        }
+    }
+}
+
+TEST(ConditionEvaluatorTest, CompiledProgramShortCircuits)
+{
+    StoredTypePattern pattern;
+    pattern.type                      = StoredPluginType::Recommended;
+    pattern.dependencies.operatorType = StoredOperator::And;
+    pattern.dependencies.fileDependencies.push_back({ "A.esp", StoredFileState::Active });
+    pattern.dependencies.fileDependencies.push_back({ "B.esp", StoredFileState::Active });
+    pattern.dependencies.fileDependencies.push_back({ "C.esp", StoredFileState::Active });
+
+    int lookups         = 0;
+    const auto resolver = [&lookups](const std::string&) {
+        ++lookups;
+        return StoredFileState::Missing;
+    };
+
+    EXPECT_FALSE(ConditionProgram::compile(pattern).evaluate(resolver));
+    EXPECT_EQ(lookups, 1); // A is missing, so B and C are never resolved
+}
+
+TEST(ConditionEvaluatorTest, CompiledEmptyNestedBlockIsFalse)
+{
+    StoredDependencies emptyInner;
+    emptyInner.operatorType = StoredOperator::And;
+
+    StoredTypePattern pattern;
+    pattern.type                      = StoredPluginType::Recommended;
+    pattern.dependencies.operatorType = StoredOperator::Or;
+    pattern.dependencies.nestedDependencies.push_back(emptyInner);
+
+    const auto resolver = makeResolver({});
+    EXPECT_FALSE(ConditionProgram::compile(pattern).evaluate(resolver));
+    EXPECT_FALSE(ConditionEvaluator::evaluateDependencies(pattern.dependencies, resolver));
+}
+
+TEST(ConditionEvaluatorTest, ResolveMatchingTypeForOptionUsesCompiledPrograms)
+{
+    StoredTypePattern notUsable;
+    notUsable.type                      = StoredPluginType::NotUsable;
+    notUsable.dependencies.operatorType = StoredOperator::And;
+    notUsable.dependencies.fileDependencies.push_back({ "AOS.esp", StoredFileState::Active });
+
+    StoredTypePattern flagOnly;
+    flagOnly.type                      = StoredPluginType::Required;
+    flagOnly.dependencies.operatorType = StoredOperator::And;
+    flagOnly.dependencies.flagDependencies.push_back({ "SomeFlag", "On" });
+
+    const auto option = makeOption({ notUsable, flagOnly, makeNestedPattern() });
+    ASSERT_EQ(option.conditionPrograms.size(), 3);
+
+    const auto resolver
+        = makeResolver({ { "A.esp", StoredFileState::Active }, { "B.esp", StoredFileState::Active } });
+    EXPECT_EQ(ConditionEvaluator::resolveMatchingType(option, resolver), StoredPluginType::Recommended);
+
+    const auto aosResolver = makeResolver({ { "AOS.esp", StoredFileState::Active } });
+    EXPECT_EQ(ConditionEvaluator::resolveMatchingType(option, aosResolver), StoredPluginType::NotUsable);
+
+    EXPECT_FALSE(ConditionEvaluator::resolveMatchingType(option, makeResolver({})).has_value());
+}
@@ -0,0 +1,71 @@
+#include "FOMODData/ExtractionScratch.h"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace {
+void writeFile(const QString& path, const size_t size)
+{
+    const std::filesystem::path file = path.toStdWString();
+    std::filesystem::create_directories(file.parent_path());
+    std::ofstream(file, std::ios::binary) << std::string(size, 'x');
+}
+}
+
+TEST(ExtractionScratchTest, ClearKeepsDirectories)
+{
+    ExtractionScratch scratch;
+    ASSERT_TRUE(scratch.isValid());
+
+    scratch.begin();
+    const auto moduleConfig = scratch.filePath("ModuleConfig.xml");
+    const auto plugin       = scratch.filePath("plugins/Option A/Patch.esp");
+    writeFile(moduleConfig, 100);
+    writeFile(plugin, 50);
+    scratch.recordWritten(moduleConfig);
+    scratch.recordWritten(plugin);
+    EXPECT_EQ(150, scratch.heldBytes());
+
+    scratch.clear();
+    const std::filesystem::path root = scratch.path().toStdWString();
+    EXPECT_TRUE(std::filesystem::is_directory(root / "plugins"));
+    EXPECT_FALSE(std::filesystem::exists(moduleConfig.toStdWString()));
+    EXPECT_FALSE(std::filesystem::exists(root / "plugins" / "Option A"));
+    EXPECT_EQ(0, scratch.heldBytes());
+}
+
+TEST(ExtractionScratchTest, Stats)
+{
+    ExtractionScratch scratch;
+    for (const size_t size : { 10, 30, 20 }) {
+        scratch.begin(); // Deletes the previous extraction
+        const auto plugin = scratch.filePath("plugins/Plugin.esp");
+        writeFile(plugin, size);
+        scratch.recordWritten(plugin);
+    }
+    scratch.clear();
+
+    const auto& stats = scratch.stats();
+    EXPECT_EQ(3, stats.extractions);
+    EXPECT_EQ(60, stats.bytesWritten);
+    EXPECT_EQ(60, stats.bytesReclaimed);
+    EXPECT_EQ(30, stats.peakBytes);
+
+    ExtractionScratch::Stats total;
+    total += stats;
+    total += stats;
+    EXPECT_EQ(6, total.extractions);
+    EXPECT_EQ(120, total.bytesWritten);
+    EXPECT_EQ(30, total.peakBytes);
+}
+
+TEST(ExtractionScratchTest, SizeCap)
+{
+    EXPECT_TRUE(ExtractionScratch().fits(UINT64_MAX));
+
+    const ExtractionScratch capped(1024);
+    EXPECT_TRUE(capped.fits(1024));
+    EXPECT_FALSE(capped.fits(1025));
+    EXPECT_EQ(1024, capped.sizeCap());
+}
@@ -140,4 +140,193 @@ TEST_F(FomodDBTest, ToJsonSerializesAllEntries)
     EXPECT_EQ(2, result[1]["options"].size());
     EXPECT_EQ("Option A", result[1]["options"][0]["name"]);
     EXPECT_EQ("Option B", result[1]["options"][1]["name"]);
-}
\ No newline at end of file
+}
+TEST_F(FomodDBTest, SaveWritesBinaryAndReloads)
+{
+    {
+        FomodDB db(tempDir, "test.db");
+        std::vector<FomodOption> options
+            = { FomodOption("Option 1", "plugin1.esp", { "master1.esm" }, "Step 1", "Group 1") };
+        db.addEntry(std::make_shared<FomodDbEntry>(12345, "First Mod", options));
+        db.saveToFile();
+    }
+
+    std::ifstream file(dbPath, std::ios::binary);
+    const std::vector<char> bytes((std::istreambuf_iterator(file)), std::istreambuf_iterator<char>());
+    EXPECT_TRUE(FomodDBBinary::isBinary(bytes));
+
+    FomodDB reloaded(tempDir, "test.db");
+    ASSERT_EQ(1, reloaded.getEntries().size());
+    EXPECT_EQ("First Mod", reloaded.getEntries()[0]->getDisplayName());
+    EXPECT_EQ("master1.esm", reloaded.getEntries()[0]->getOptions()[0].masters[0]);
+}
+
+TEST_F(FomodDBTest, CreatesEmptyBinaryDbWhenMissing)
+{
+    FomodDB db(tempDir, "missing.db");
+    EXPECT_TRUE(db.getEntries().empty());
+    EXPECT_TRUE(std::filesystem::exists(tempDir + "/missing.db"));
+
+    FomodDB reloaded(tempDir, "missing.db");
+    EXPECT_TRUE(reloaded.getEntries().empty());
+}
+
+TEST_F(FomodDBTest, ExportAndImportJson)
+{
+    FomodDB legacy(TEST_DATA_DIR, "test-db.json");
+    const auto exportPath = tempDir + "/export.json";
+    ASSERT_TRUE(legacy.exportJson(exportPath));
+
+    FomodDB db(tempDir, "test.db");
+    ASSERT_TRUE(db.importJson(exportPath));
+    EXPECT_EQ(db.toJson(), legacy.toJson());
+}
+
+TEST_F(FomodDBTest, FindByModIdAndName)
+{
+    FomodDB db(tempDir, "test.db");
+    std::vector<FomodOption> options
+        = { FomodOption("Option 1", "plugin1.esp", { "master1.esm" }, "Step 1", "Group 1") };
+    db.addEntry(std::make_shared<FomodDbEntry>(12345, "Nexus Mod", options));
+    db.addEntry(std::make_shared<FomodDbEntry>(0, "Manual Mod", options));
+    db.addEntry(std::make_shared<FomodDbEntry>(0, "Other Manual Mod", options));
+
+    ASSERT_NE(nullptr, db.findByModId(12345));
+    EXPECT_EQ("Nexus Mod", db.findByModId(12345)->getDisplayName());
+    ASSERT_NE(nullptr, db.findByName("Manual Mod"));
+    EXPECT_EQ(0, db.findByName("Manual Mod")->getModId());
+    EXPECT_EQ(nullptr, db.findByModId(99999));
+    EXPECT_EQ(nullptr, db.findByModId(0));
+    EXPECT_EQ(nullptr, db.findByName("Nexus Mod")); // Only modId 0 entries are indexed by name
+
+    // Manual installs are upserted by display name, not collapsed onto each other via modId 0
+    db.addEntry(std::make_shared<FomodDbEntry>(0, "Manual Mod", std::vector<FomodOption> {}));
+    EXPECT_EQ(3, db.getEntries().size());
+    EXPECT_TRUE(db.findByName("Manual Mod")->getOptions().empty());
+}
+
+TEST_F(FomodDBTest, FindMatchesNegativeModIdsById)
+{
+    FomodDB db(tempDir, "test.db");
+    db.addEntry(std::make_shared<FomodDbEntry>(-1, "Unknown ID", std::vector<FomodOption> {}));
+    db.addEntry(std::make_shared<FomodDbEntry>(0, "Manual Mod", std::vector<FomodOption> {}));
+
+    ASSERT_NE(nullptr, db.find(-1, "Unknown ID"));
+    EXPECT_EQ(-1, db.find(-1, "Unknown ID")->getModId());
+    EXPECT_EQ(nullptr, db.findByName("Unknown ID"));
+    ASSERT_NE(nullptr, db.find(0, "Manual Mod"));
+    EXPECT_EQ(nullptr, db.find(0, "Unknown ID"));
+}
+
+TEST_F(FomodDBTest, IndexSurvivesReloadAndRemoval)
+{
+    FomodDB db(tempDir, "test.db");
+    std::vector<FomodOption> options
+        = { FomodOption("Option 1", "plugin1.esp", { "master1.esm" }, "Step 1", "Group 1") };
+    db.addEntry(std::make_shared<FomodDbEntry>(1, "First", options));
+    db.addEntry(std::make_shared<FomodDbEntry>(2, "Second", options));
+    db.addEntry(std::make_shared<FomodDbEntry>(0, "Manual", options));
+    db.saveToFile();
+    db.commitEntry(std::make_shared<FomodDbEntry>(3, "Third", options));
+
+    db.reload();
+    ASSERT_NE(nullptr, db.findByModId(3));
+    EXPECT_EQ("Third", db.findByModId(3)->getDisplayName());
+
+    // Removing an entry shifts the ones after it; their lookups must follow
+    ASSERT_TRUE(db.removeEntry(1, "First"));
+    EXPECT_EQ(nullptr, db.findByModId(1));
+    EXPECT_EQ("Second", db.findByModId(2)->getDisplayName());
+    EXPECT_EQ("Manual", db.findByName("Manual")->getDisplayName());
+    EXPECT_EQ("Third", db.findByModId(3)->getDisplayName());
+
+    db.addEntry(std::make_shared<FomodDbEntry>(3, "Third Updated", options));
+    EXPECT_EQ(3, db.getEntries().size());
+    EXPECT_EQ("Third Updated", db.getEntries()[2]->getDisplayName());
+}
+
+TEST_F(FomodDBTest, UnreadableDbIsMovedAsideNotOverwritten)
+{
+    // A DB from a newer version of the plugin
+    std::string newer(FomodDBBinary::MAGIC, sizeof(FomodDBBinary::MAGIC));
+    const uint32_t version = FomodDBBinary::VERSION + 1;
+    newer.append(reinterpret_cast<const char*>(&version), sizeof(version));
+    newer.append(64, '\0');
+    std::ofstream(dbPath, std::ios::binary | std::ios::trunc) << newer;
+
+    std::vector<FomodOption> options
+        = { FomodOption("Option 1", "plugin1.esp", { "master1.esm" }, "Step 1", "Group 1") };
+    {
+        FomodDB db(tempDir, "test.db");
+        EXPECT_TRUE(db.baseLoadFailed());
+        EXPECT_TRUE(db.getEntries().empty());
+        db.commitEntry(std::make_shared<FomodDbEntry>(1, "First", options));
+    } // Compacts on destruction
+
+    std::ifstream bad(dbPath + ".bad", std::ios::binary);
+    ASSERT_TRUE(bad.is_open());
+    EXPECT_EQ(newer, std::string((std::istreambuf_iterator(bad)), std::istreambuf_iterator<char>()));
+
+    FomodDB reloaded(tempDir, "test.db");
+    EXPECT_FALSE(reloaded.baseLoadFailed());
+    ASSERT_EQ(1, reloaded.getEntries().size());
+    EXPECT_EQ("First", reloaded.getEntries()[0]->getDisplayName());
+}
+
+namespace {
+// A TES4 record whose only subrecords are its masters
+std::vector<char> makeHeaderRecord(const std::vector<std::string>& masters)
+{
+    std::string fields;
+    for (const auto& master : masters) {
+        const auto size = static_cast<uint16_t>(master.size() + 1);
+        fields.append("MAST");
+        fields.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        fields.append(master).push_back('\0');
+    }
+    std::string record = "TES4";
+    const auto dataSize = static_cast<uint32_t>(fields.size());
+    record.append(reinterpret_cast<const char*>(&dataSize), sizeof(dataSize));
+    record.append(PluginReader::RECORD_HEADER_SIZE - record.size(), '\0');
+    record.append(fields);
+    return { record.begin(), record.end() };
+}
+
+ModuleConfiguration makeFomodWithPlugin(const std::string& source)
+{
+    ModuleConfiguration fomod;
+    fomod.moduleName = "Patches";
+    auto& plugin     = fomod.installSteps.installSteps.emplace_back()
+                       .optionalFileGroups.groups.emplace_back()
+                       .plugins.plugins.emplace_back();
+    plugin.name = "Patch";
+    plugin.files.files.emplace_back().source = source;
+    return fomod;
+}
+} // namespace
+
+TEST_F(FomodDBTest, SameNamedPluginsFromDifferentArchivesKeepTheirOwnHeaders)
+{
+    auto fomod = makeFomodWithPlugin("patches\\Patch.esp");
+    const ExtractedPlugin hagsCure { "patches/Patch.esp", makeHeaderRecord({ "Skyrim.esm", "Lux.esp" }), 1024, 0x1111 };
+    const ExtractedPlugin ordinator { "patches/Patch.esp", makeHeaderRecord({ "Ordinator.esp" }), 2048, 0x2222 };
+    // The same file as hagsCure in a third archive, left compressed because the cache already has it
+    const ExtractedPlugin hagsCureCopy { "patches/Patch.esp", {}, 1024, 0x1111 };
+
+    MastersCache cache;
+    const auto first  = FomodDB::getEntryFromFomod(&fomod, { hagsCure }, 1, &cache);
+    const auto second = FomodDB::getEntryFromFomod(&fomod, { ordinator }, 2, &cache);
+    const auto third  = FomodDB::getEntryFromFomod(&fomod, { hagsCureCopy }, 3, &cache);
+    EXPECT_EQ(2, cache.size());
+
+    const auto& firstOption  = first->getOptions().at(0);
+    const auto& secondOption = second->getOptions().at(0);
+    const auto& thirdOption  = third->getOptions().at(0);
+    ASSERT_TRUE(firstOption.pluginHeader.known());
+    ASSERT_TRUE(secondOption.pluginHeader.known());
+    EXPECT_NE(firstOption.pluginHeader.checksum, secondOption.pluginHeader.checksum);
+    EXPECT_EQ(std::vector<StringId> { StringId("Lux.esp") }, firstOption.masters);
+    EXPECT_EQ(std::vector<StringId> { StringId("Ordinator.esp") }, secondOption.masters);
+    EXPECT_EQ(firstOption.pluginHeader.checksum, thirdOption.pluginHeader.checksum);
+    EXPECT_EQ(firstOption.masters, thirdOption.masters);
+}
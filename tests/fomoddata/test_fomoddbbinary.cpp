@@ -0,0 +1,169 @@
+#include "FOMODData/FomodDBBinary.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+std::vector<std::shared_ptr<FomodDbEntry>> makeEntries()
+{
+    StoredTypePattern pattern;
+    pattern.type                      = StoredPluginType::Recommended;
+    pattern.dependencies.operatorType = StoredOperator::Or;
+    pattern.dependencies.fileDependencies.push_back({ "TKDodge.esp", StoredFileState::Active });
+    pattern.dependencies.flagDependencies.push_back({ "SomeFlag", "On" });
+
+    StoredDependencies nested;
+    nested.operatorType = StoredOperator::And;
+    nested.fileDependencies.push_back({ "Lux.esp", StoredFileState::Inactive });
+    pattern.dependencies.nestedDependencies.push_back(nested);
+
+    std::vector<FomodOption> luxOptions;
+    luxOptions.emplace_back("JK's The Hag's Cure", "Lux - JK's The Hag's Cure patch.esp",
+        std::vector<StringId> { "Skyrim.esm", "JK's The Hag's Cure.esp", "Lux.esp" }, "Page One", "Group One",
+        SelectionState::Deselected, std::vector { pattern });
+    luxOptions.back().pluginHeader = { StoredPluginHeader::FLAG_LIGHT, 3, 24, 0, 0xC0FFEE };
+    luxOptions.emplace_back("No Plugin", "", std::vector<StringId> {}, "Page One", "Group One");
+
+    std::vector<FomodOption> otherOptions;
+    otherOptions.emplace_back("Option A", "pluginA.esp", std::vector<StringId> { "Lux.esp" }, "Page One",
+        "Group Two", SelectionState::Selected);
+
+    return {
+        std::make_shared<FomodDbEntry>(12345, "Lux (Patch Hub)", luxOptions),
+        std::make_shared<FomodDbEntry>(0, "Manual Mod", otherOptions),
+    };
+}
+
+} // namespace
+
+TEST(FomodDBBinaryTest, RoundTripPreservesEntries)
+{
+    const auto entries = makeEntries();
+    const auto bytes   = FomodDBBinary::serialize(entries);
+
+    ASSERT_TRUE(FomodDBBinary::isBinary(bytes));
+
+    FomodDBBinary::Entries decoded;
+    ASSERT_TRUE(FomodDBBinary::deserialize(bytes, decoded));
+    ASSERT_EQ(decoded.size(), entries.size());
+
+    // JSON is the canonical representation, so equal JSON means nothing was lost.
+    for (size_t i = 0; i < entries.size(); ++i) {
+        EXPECT_EQ(decoded[i]->toJson(), entries[i]->toJson());
+    }
+
+    const auto& option = decoded[0]->getOptions()[0];
+    EXPECT_EQ(option.selectionState, SelectionState::Deselected);
+    EXPECT_EQ(option.pluginHeader, entries[0]->getOptions()[0].pluginHeader);
+    EXPECT_TRUE(option.pluginHeader.isLight());
+    EXPECT_FALSE(decoded[0]->getOptions()[1].pluginHeader.known());
+    ASSERT_EQ(option.typePatterns.size(), 1);
+    ASSERT_EQ(option.typePatterns[0].dependencies.nestedDependencies.size(), 1);
+    EXPECT_EQ(option.typePatterns[0].dependencies.nestedDependencies[0].fileDependencies[0].file, "Lux.esp");
+}
+
+TEST(FomodDBBinaryTest, InternsRepeatedStrings)
+{
+    const auto bytes = FomodDBBinary::serialize(makeEntries());
+
+    // "Lux.esp" is referenced four times but stored once in the string table.
+    const std::string_view view(bytes.data(), bytes.size());
+    const auto first = view.find("Lux.esp");
+    ASSERT_NE(first, std::string_view::npos);
+    EXPECT_EQ(view.find("Lux.esp", first + 1), std::string_view::npos);
+}
+
+TEST(FomodDBBinaryTest, EmptyDatabase)
+{
+    const auto bytes = FomodDBBinary::serialize({});
+
+    FomodDBBinary::Entries decoded;
+    EXPECT_TRUE(FomodDBBinary::deserialize(bytes, decoded));
+    EXPECT_TRUE(decoded.empty());
+}
+
+TEST(FomodDBBinaryTest, RejectsJsonAndBadVersion)
+{
+    FomodDBBinary::Entries decoded;
+
+    const std::string json = "[]";
+    EXPECT_FALSE(FomodDBBinary::isBinary(json));
+    EXPECT_FALSE(FomodDBBinary::deserialize(json, decoded));
+
+    auto bytes = FomodDBBinary::serialize(makeEntries());
+    bytes[4]   = static_cast<char>(FomodDBBinary::VERSION + 1);
+    EXPECT_FALSE(FomodDBBinary::deserialize(bytes, decoded));
+    EXPECT_TRUE(decoded.empty());
+}
+
+TEST(FomodDBBinaryTest, RejectsTruncatedData)
+{
+    const auto bytes = FomodDBBinary::serialize(makeEntries());
+
+    // Every possible truncation must fail cleanly rather than read out of bounds.
+    for (size_t length = 0; length < bytes.size(); ++length) {
+        FomodDBBinary::Entries decoded;
+        EXPECT_FALSE(FomodDBBinary::deserialize(std::span(bytes.data(), length), decoded)) << "length " << length;
+        EXPECT_TRUE(decoded.empty());
+    }
+}
+
+TEST(FomodDBBinaryTest, ReadsVersionOneStringEnums)
+{
+    // Version 1 stored pattern type, operator and file state as string ids instead of bytes.
+    const std::vector<std::string> strings = { "Mod", "Option", "patch.esp", "Step", "Group", "Lux.esp", "Recommended",
+        "Or", "Inactive" };
+
+    BinaryWriter out;
+    out.writeBytes({ FomodDBBinary::MAGIC, sizeof(FomodDBBinary::MAGIC) });
+    out.write<uint32_t>(1);
+    out.write<uint32_t>(static_cast<uint32_t>(strings.size()));
+    out.write<uint32_t>(1);
+    const uint64_t stringTableOffset = 4 + 3 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+    out.write<uint64_t>(stringTableOffset);
+    const auto entryIndexOffsetPos = out.size();
+    out.write<uint64_t>(0);
+
+    uint32_t offset = 0;
+    for (const auto& str : strings) {
+        out.write<uint32_t>(offset);
+        offset += static_cast<uint32_t>(str.size());
+    }
+    out.write<uint32_t>(offset);
+    for (const auto& str : strings) {
+        out.writeBytes(str);
+    }
+
+    out.patch<uint64_t>(entryIndexOffsetPos, out.size());
+    out.write<uint64_t>(out.size() + sizeof(uint64_t));
+
+    out.write<int32_t>(42);
+    out.write<uint32_t>(0); // displayName
+    out.write<uint32_t>(1); // optionCount
+    for (const uint32_t id : { 1u, 2u, 3u, 4u }) {
+        out.write<uint32_t>(id); // name, fileName, step, group
+    }
+    out.write<uint8_t>(static_cast<uint8_t>(SelectionState::Available));
+    out.write<uint32_t>(1); // masterCount
+    out.write<uint32_t>(5);
+    out.write<uint32_t>(1); // patternCount
+    out.write<uint32_t>(6); // type
+    out.write<uint32_t>(7); // operator
+    out.write<uint32_t>(1); // fileCount
+    out.write<uint32_t>(5);
+    out.write<uint32_t>(8); // state
+    out.write<uint32_t>(0); // flagCount
+    out.write<uint32_t>(0); // nestedCount
+
+    FomodDBBinary::Entries decoded;
+    ASSERT_TRUE(FomodDBBinary::deserialize(out.buffer(), decoded));
+    ASSERT_EQ(decoded.size(), 1);
+
+    const auto& option = decoded[0]->getOptions()[0];
+    EXPECT_EQ(option.fileName, "patch.esp");
+    EXPECT_EQ(option.masters[0], "Lux.esp");
+    ASSERT_EQ(option.typePatterns.size(), 1);
+    EXPECT_EQ(option.typePatterns[0].type, StoredPluginType::Recommended);
+    EXPECT_EQ(option.typePatterns[0].dependencies.operatorType, StoredOperator::Or);
+    EXPECT_EQ(option.typePatterns[0].dependencies.fileDependencies[0].state, StoredFileState::Inactive);
+}
@@ -52,20 +52,22 @@ TEST(FomodDbEntryTest, ParseFomodDbEntry)
 
     // Verify typePatterns
     ASSERT_EQ(fomodDbEntry.getOptions()[0].typePatterns.size(), 1);
-    EXPECT_EQ(fomodDbEntry.getOptions()[0].typePatterns[0].type, "Recommended");
-    EXPECT_EQ(fomodDbEntry.getOptions()[0].typePatterns[0].dependencies.operatorType, "Or");
+    EXPECT_EQ(fomodDbEntry.getOptions()[0].typePatterns[0].type, StoredPluginType::Recommended);
+    EXPECT_EQ(fomodDbEntry.getOptions()[0].typePatterns[0].dependencies.operatorType, StoredOperator::Or);
     ASSERT_EQ(fomodDbEntry.getOptions()[0].typePatterns[0].dependencies.fileDependencies.size(), 2);
     EXPECT_EQ(fomodDbEntry.getOptions()[0].typePatterns[0].dependencies.fileDependencies[0].file, "TKDodge.esp");
-    EXPECT_EQ(fomodDbEntry.getOptions()[0].typePatterns[0].dependencies.fileDependencies[0].state, "Active");
+    EXPECT_EQ(
+        fomodDbEntry.getOptions()[0].typePatterns[0].dependencies.fileDependencies[0].state, StoredFileState::Active);
     EXPECT_EQ(
         fomodDbEntry.getOptions()[0].typePatterns[0].dependencies.fileDependencies[1].file, "UltimateCombat.esp");
-    EXPECT_EQ(fomodDbEntry.getOptions()[0].typePatterns[0].dependencies.fileDependencies[1].state, "Active");
+    EXPECT_EQ(
+        fomodDbEntry.getOptions()[0].typePatterns[0].dependencies.fileDependencies[1].state, StoredFileState::Active);
 }
 
 TEST(FomodDbEntryTest, ToJsonSerializesCorrectly)
 {
     // Create a FomodOption
-    std::vector<std::string> masters
+    std::vector<StringId> masters
         = { "Skyrim.esm", "JK's The Hag's Cure.esp", "Lux - Resources.esp", "Lux.esp" };
     FomodOption option(
         "JK's The Hag's Cure", "Lux - JK's The Hag's Cure patch.esp", masters, "Step One", "Group One");
@@ -124,10 +126,10 @@ TEST(FomodDbEntryTest, TypePatternsRoundTrip)
 {
     // Create an option with typePatterns
     StoredTypePattern pattern;
-    pattern.type                 = "Recommended";
-    pattern.dependencies.operatorType = "Or";
-    pattern.dependencies.fileDependencies.push_back({ "AOS.esp", "Active" });
-    pattern.dependencies.fileDependencies.push_back({ "ELFX.esp", "Active" });
+    pattern.type                 = StoredPluginType::Recommended;
+    pattern.dependencies.operatorType = StoredOperator::Or;
+    pattern.dependencies.fileDependencies.push_back({ "AOS.esp", StoredFileState::Active });
+    pattern.dependencies.fileDependencies.push_back({ "ELFX.esp", StoredFileState::Active });
     pattern.dependencies.flagDependencies.push_back({ "MyFlag", "On" });
 
     FomodOption option("AOS Patch", "AOS_Patch.esp", { "master.esm" }, "Patches", "Audio",
@@ -151,11 +153,11 @@ TEST(FomodDbEntryTest, TypePatternsRoundTrip)
     ASSERT_EQ(roundTripped.getOptions()[0].typePatterns.size(), 1);
 
     const auto& tp = roundTripped.getOptions()[0].typePatterns[0];
-    EXPECT_EQ(tp.type, "Recommended");
-    EXPECT_EQ(tp.dependencies.operatorType, "Or");
+    EXPECT_EQ(tp.type, StoredPluginType::Recommended);
+    EXPECT_EQ(tp.dependencies.operatorType, StoredOperator::Or);
     ASSERT_EQ(tp.dependencies.fileDependencies.size(), 2);
     EXPECT_EQ(tp.dependencies.fileDependencies[0].file, "AOS.esp");
-    EXPECT_EQ(tp.dependencies.fileDependencies[0].state, "Active");
+    EXPECT_EQ(tp.dependencies.fileDependencies[0].state, StoredFileState::Active);
     EXPECT_EQ(tp.dependencies.fileDependencies[1].file, "ELFX.esp");
     ASSERT_EQ(tp.dependencies.flagDependencies.size(), 1);
     EXPECT_EQ(tp.dependencies.flagDependencies[0].flag, "MyFlag");
@@ -166,14 +168,14 @@ TEST(FomodDbEntryTest, NestedDependenciesRoundTrip)
 {
     // Create nested dependencies: AND(file1, OR(file2, file3))
     StoredDependencies inner;
-    inner.operatorType = "Or";
-    inner.fileDependencies.push_back({ "ELFX.esp", "Active" });
-    inner.fileDependencies.push_back({ "SMIM.esp", "Active" });
+    inner.operatorType = StoredOperator::Or;
+    inner.fileDependencies.push_back({ "ELFX.esp", StoredFileState::Active });
+    inner.fileDependencies.push_back({ "SMIM.esp", StoredFileState::Active });
 
     StoredTypePattern pattern;
-    pattern.type                 = "Required";
-    pattern.dependencies.operatorType = "And";
-    pattern.dependencies.fileDependencies.push_back({ "AOS.esp", "Active" });
+    pattern.type                 = StoredPluginType::Required;
+    pattern.dependencies.operatorType = StoredOperator::And;
+    pattern.dependencies.fileDependencies.push_back({ "AOS.esp", StoredFileState::Active });
     pattern.dependencies.nestedDependencies.push_back(inner);
 
     FomodOption option("Nested", "nested.esp", {}, "S", "G", SelectionState::Unknown, { pattern });
@@ -184,10 +186,10 @@ TEST(FomodDbEntryTest, NestedDependenciesRoundTrip)
     FomodDbEntry roundTripped(json);
 
     const auto& tp = roundTripped.getOptions()[0].typePatterns[0];
-    EXPECT_EQ(tp.dependencies.operatorType, "And");
+    EXPECT_EQ(tp.dependencies.operatorType, StoredOperator::And);
     ASSERT_EQ(tp.dependencies.fileDependencies.size(), 1);
     ASSERT_EQ(tp.dependencies.nestedDependencies.size(), 1);
-    EXPECT_EQ(tp.dependencies.nestedDependencies[0].operatorType, "Or");
+    EXPECT_EQ(tp.dependencies.nestedDependencies[0].operatorType, StoredOperator::Or);
     ASSERT_EQ(tp.dependencies.nestedDependencies[0].fileDependencies.size(), 2);
     EXPECT_EQ(tp.dependencies.nestedDependencies[0].fileDependencies[0].file, "ELFX.esp");
     EXPECT_EQ(tp.dependencies.nestedDependencies[0].fileDependencies[1].file, "SMIM.esp");
@@ -0,0 +1,173 @@
+#include "FOMODData/FomodDb.h"
+
+#include <fstream>
+#include <gtest/gtest.h>
+
+class FomodDBJournalTest : public ::testing::Test {
+  protected:
+    std::string tempDir;
+    std::string dbPath;
+    std::string journalPath;
+
+    void SetUp() override
+    {
+        tempDir
+            = std::filesystem::temp_directory_path().string() + "/fomod_journal_test_" + std::to_string(std::rand());
+        std::filesystem::create_directory(tempDir);
+        dbPath      = tempDir + "/test.db";
+        journalPath = dbPath + ".journal";
+    }
+
+    void TearDown() override { std::filesystem::remove_all(tempDir); }
+
+    static std::shared_ptr<FomodDbEntry> makeEntry(const int modId, const std::string& name)
+    {
+        std::vector<FomodOption> options
+            = { FomodOption(name + " Option", name + ".esp", { "Skyrim.esm" }, "Step", "Group") };
+        return std::make_shared<FomodDbEntry>(modId, name, options);
+    }
+};
+
+TEST_F(FomodDBJournalTest, CommitAppendsToJournalWithoutRewritingBase)
+{
+    FomodDB db(tempDir, "test.db");
+    db.setJournalCompactThreshold(UINTMAX_MAX);
+    const auto baseSize = std::filesystem::file_size(dbPath);
+
+    db.commitEntry(makeEntry(1, "First"));
+    db.commitEntry(makeEntry(2, "Second"));
+
+    EXPECT_EQ(baseSize, std::filesystem::file_size(dbPath));
+    EXPECT_FALSE(db.getJournal().empty());
+
+    // A second instance (e.g. the Patch Finder) sees the journaled entries.
+    FomodDB reader(tempDir, "test.db");
+    ASSERT_EQ(2, reader.getEntries().size());
+    EXPECT_EQ("First", reader.getEntries()[0]->getDisplayName());
+    EXPECT_EQ("Second", reader.getEntries()[1]->getDisplayName());
+}
+
+TEST_F(FomodDBJournalTest, UpsertAndRemoveReplayInOrder)
+{
+    {
+        FomodDB db(tempDir, "test.db");
+        db.setJournalCompactThreshold(UINTMAX_MAX);
+        db.commitEntry(makeEntry(1, "First"));
+        db.commitEntry(makeEntry(1, "First Renamed"));
+        db.commitEntry(makeEntry(0, "Manual"));
+        EXPECT_TRUE(db.removeEntry(0, "Manual"));
+        EXPECT_FALSE(db.removeEntry(99, "Not There"));
+
+        FomodDB reader(tempDir, "test.db");
+        ASSERT_EQ(1, reader.getEntries().size());
+        EXPECT_EQ("First Renamed", reader.getEntries()[0]->getDisplayName());
+    }
+
+    // Destroying the writer compacted the journal into the base file.
+    EXPECT_FALSE(std::filesystem::exists(journalPath));
+    FomodDB reloaded(tempDir, "test.db");
+    ASSERT_EQ(1, reloaded.getEntries().size());
+    EXPECT_EQ("First Renamed", reloaded.getEntries()[0]->getDisplayName());
+}
+
+TEST_F(FomodDBJournalTest, CompactionAtThreshold)
+{
+    FomodDB db(tempDir, "test.db");
+    db.setJournalCompactThreshold(0);
+
+    db.commitEntry(makeEntry(1, "First"));
+
+    EXPECT_TRUE(db.getJournal().empty());
+    FomodDB reader(tempDir, "test.db");
+    ASSERT_EQ(1, reader.getEntries().size());
+}
+
+TEST_F(FomodDBJournalTest, CompactionKeepsRecordsFromOtherInstances)
+{
+    FomodDB installer(tempDir, "test.db");
+    FomodDB patchFinder(tempDir, "test.db");
+    installer.setJournalCompactThreshold(UINTMAX_MAX);
+    patchFinder.setJournalCompactThreshold(UINTMAX_MAX);
+
+    installer.commitEntry(makeEntry(1, "From Installer"));
+    patchFinder.commitEntry(makeEntry(2, "From Patch Finder"));
+    installer.compact();
+
+    EXPECT_EQ(2, installer.getEntries().size());
+    FomodDB reader(tempDir, "test.db");
+    EXPECT_EQ(2, reader.getEntries().size());
+}
+
+TEST_F(FomodDBJournalTest, TornTailIsDiscarded)
+{
+    FomodDB db(tempDir, "test.db");
+    db.setJournalCompactThreshold(UINTMAX_MAX);
+    db.commitEntry(makeEntry(1, "First"));
+
+    // Simulate a crash halfway through writing a record.
+    {
+        std::ofstream journal(journalPath, std::ios::binary | std::ios::app);
+        journal.write("\x01\xff\x00\x00", 4);
+    }
+
+    FomodDB afterCrash(tempDir, "test.db");
+    afterCrash.setJournalCompactThreshold(UINTMAX_MAX);
+    ASSERT_EQ(1, afterCrash.getEntries().size());
+
+    // Appends after the repair are replayable.
+    afterCrash.commitEntry(makeEntry(2, "Second"));
+    FomodDB reader(tempDir, "test.db");
+    EXPECT_EQ(2, reader.getEntries().size());
+}
+
+TEST_F(FomodDBJournalTest, ChangedOnDiskSeesOtherInstances)
+{
+    FomodDB installer(tempDir, "test.db");
+    FomodDB patchFinder(tempDir, "test.db");
+    installer.setJournalCompactThreshold(UINTMAX_MAX);
+    patchFinder.setJournalCompactThreshold(UINTMAX_MAX);
+    EXPECT_FALSE(patchFinder.changedOnDisk());
+
+    // Our own writes don't count as outside changes.
+    patchFinder.commitEntry(makeEntry(1, "From Patch Finder"));
+    EXPECT_FALSE(patchFinder.changedOnDisk());
+
+    installer.commitEntry(makeEntry(2, "From Installer"));
+    EXPECT_TRUE(patchFinder.changedOnDisk());
+
+    patchFinder.reload();
+    EXPECT_FALSE(patchFinder.changedOnDisk());
+    EXPECT_EQ(2, patchFinder.getEntries().size());
+}
+
+TEST_F(FomodDBJournalTest, BulkCommitKeepsRecordsFromOtherInstances)
+{
+    FomodDB installer(tempDir, "test.db");
+    FomodDB rescan(tempDir, "test.db");
+    installer.setJournalCompactThreshold(UINTMAX_MAX);
+
+    // Installed while the rescan was running
+    installer.commitEntry(makeEntry(1, "Installed"));
+    rescan.commitEntries({ makeEntry(2, "Rescanned") });
+
+    EXPECT_TRUE(rescan.getJournal().empty());
+    FomodDB reader(tempDir, "test.db");
+    ASSERT_EQ(2, reader.getEntries().size());
+    EXPECT_NE(nullptr, reader.findByModId(1));
+    EXPECT_NE(nullptr, reader.findByModId(2));
+}
+
+TEST_F(FomodDBJournalTest, FailedAppendRewritesBase)
+{
+    FomodDB db(tempDir, "test.db");
+    db.setJournalCompactThreshold(UINTMAX_MAX);
+
+    // A directory in the journal's place can't be appended to
+    std::filesystem::create_directories(journalPath + "/blocked");
+    db.commitEntry(makeEntry(1, "First"));
+
+    std::filesystem::remove_all(journalPath);
+    FomodDB reader(tempDir, "test.db");
+    ASSERT_EQ(1, reader.getEntries().size());
+    EXPECT_EQ("First", reader.getEntries()[0]->getDisplayName());
+}
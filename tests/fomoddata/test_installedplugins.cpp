@@ -0,0 +1,86 @@
+#include "FOMODData/InstalledPlugins.h"
+
+#include <gtest/gtest.h>
+
+class InstalledPluginsTest : public ::testing::Test {
+  protected:
+    InstalledPlugins installed;
+    std::unordered_map<StringId, StoredFileState> pluginList; // What MO2's plugin list reports
+    std::vector<StringId> changedFiles;
+
+    InstalledPlugins::LoadOrderState loadOrder() const
+    {
+        return [this](const StringId plugin) {
+            const auto it = pluginList.find(plugin);
+            return it != pluginList.end() ? it->second : StoredFileState::Missing;
+        };
+    }
+};
+
+TEST_F(InstalledPluginsTest, AddingAModRecordsOwnersAndStates)
+{
+    pluginList[StringId("Lux.esp")] = StoredFileState::Active;
+    installed.addMod(StringId("Lux"), { StringId("Lux.esp"), StringId("Lux - Resources.esp") }, loadOrder(),
+        changedFiles);
+
+    EXPECT_TRUE(installed.isInstalled(StringId("Lux.esp")));
+    EXPECT_EQ(std::vector { StringId("Lux") }, *installed.ownersOf(StringId("Lux - Resources.esp")));
+    EXPECT_EQ(2, installed.pluginsOf(StringId("Lux"))->size());
+    EXPECT_EQ(StoredFileState::Active, installed.states().state(StringId("Lux.esp")));
+    EXPECT_EQ(StoredFileState::Missing, installed.states().state(StringId("Lux - Resources.esp")));
+    EXPECT_EQ(2, changedFiles.size());
+
+    installed.addMod(StringId("Empty"), {}, loadOrder(), changedFiles);
+    EXPECT_EQ(nullptr, installed.pluginsOf(StringId("Empty")));
+}
+
+TEST_F(InstalledPluginsTest, ReinstallKeepsLoadOrderState)
+{
+    pluginList[StringId("Lux.esp")] = StoredFileState::Active;
+    installed.addMod(StringId("Lux"), { StringId("Lux.esp") }, loadOrder(), changedFiles);
+    changedFiles.clear();
+
+    // MO2 reports no plugin state change for a plugin that stays active through a reinstall
+    installed.removeMod(StringId("Lux"), loadOrder(), changedFiles);
+    installed.addMod(StringId("Lux"), { StringId("Lux.esp") }, loadOrder(), changedFiles);
+
+    EXPECT_TRUE(installed.isInstalled(StringId("Lux.esp")));
+    EXPECT_EQ(StoredFileState::Active, installed.states().state(StringId("Lux.esp")));
+    EXPECT_EQ(StoredFileState::Active, installed.states().state(StringId("lux.esp")));
+}
+
+TEST_F(InstalledPluginsTest, RemovingAModTakesStateFromThePluginList)
+{
+    // A mod shadowing a plugin that is also in the Data folder
+    pluginList[StringId("Unofficial Patch.esp")] = StoredFileState::Active;
+    pluginList[StringId("Lux.esp")]              = StoredFileState::Active;
+    installed.addMod(StringId("Patch"), { StringId("Unofficial Patch.esp") }, loadOrder(), changedFiles);
+    installed.addMod(StringId("Lux"), { StringId("Lux.esp") }, loadOrder(), changedFiles);
+    changedFiles.clear();
+
+    pluginList.erase(StringId("Lux.esp"));
+    installed.removeMod(StringId("Patch"), loadOrder(), changedFiles);
+    installed.removeMod(StringId("Lux"), loadOrder(), changedFiles);
+
+    EXPECT_FALSE(installed.isInstalled(StringId("Unofficial Patch.esp")));
+    EXPECT_EQ(StoredFileState::Active, installed.states().state(StringId("Unofficial Patch.esp")));
+    EXPECT_EQ(StoredFileState::Missing, installed.states().state(StringId("Lux.esp")));
+    // Both lost their owner; only Lux.esp also left the load order, and it is reported once
+    EXPECT_EQ((std::vector { StringId("Unofficial Patch.esp"), StringId("Lux.esp") }), changedFiles);
+}
+
+TEST_F(InstalledPluginsTest, PluginStaysInstalledWhileAnyModProvidesIt)
+{
+    pluginList[StringId("Lux.esp")] = StoredFileState::Active;
+    installed.addMod(StringId("Lux"), { StringId("Lux.esp") }, loadOrder(), changedFiles);
+    installed.addMod(StringId("Lux (fixed)"), { StringId("Lux.esp") }, loadOrder(), changedFiles);
+    changedFiles.clear();
+
+    installed.removeMod(StringId("Lux"), loadOrder(), changedFiles);
+    EXPECT_TRUE(installed.isInstalled(StringId("Lux.esp")));
+    EXPECT_TRUE(changedFiles.empty());
+
+    EXPECT_FALSE(installed.setState(StringId("Lux.esp"), StoredFileState::Active, changedFiles));
+    EXPECT_TRUE(installed.setState(StringId("Lux.esp"), StoredFileState::Inactive, changedFiles));
+    EXPECT_EQ(std::vector { StringId("Lux.esp") }, changedFiles);
+}
@@ -0,0 +1,68 @@
+#include "FOMODData/MastersCache.h"
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+
+TEST(MastersCacheTest, ReadsOncePerPlugin)
+{
+    MastersCache cache;
+    int reads        = 0;
+    const auto first = cache.getOrRead("Lux.esp", [&reads] {
+        ++reads;
+        return PluginHeader { true, { "Skyrim.esm", "Update.esm" } };
+    });
+    const auto again = cache.getOrRead("Lux.esp", [&reads] {
+        ++reads;
+        return PluginHeader {};
+    });
+
+    EXPECT_EQ(1, reads);
+    EXPECT_EQ(first.masters, again.masters);
+    EXPECT_TRUE(again.valid);
+    EXPECT_EQ(1, cache.size());
+    EXPECT_TRUE(cache.contains("Lux.esp"));
+    EXPECT_FALSE(cache.contains("Lux - Resources.esp"));
+}
+
+TEST(MastersCacheTest, KeyedByFileNameSizeAndCrc)
+{
+    EXPECT_EQ(MastersCache::key("Lux.esp", 10, 20), MastersCache::key("patches/Lux.esp", 10, 20));
+    EXPECT_EQ(MastersCache::key("fomod\\core\\Lux.esp", 10, 20), MastersCache::key("core/Lux.esp", 10, 20));
+    EXPECT_NE(MastersCache::key("Lux.esp", 10, 20), MastersCache::key("Lux.esp", 11, 20));
+    EXPECT_NE(MastersCache::key("Lux.esp", 10, 20), MastersCache::key("Lux.esp", 10, 21));
+    EXPECT_NE(MastersCache::key("Lux.esp", 10, 20), MastersCache::key("Lux - Resources.esp", 10, 20));
+}
+
+TEST(MastersCacheTest, ConcurrentWorkersAgree)
+{
+    MastersCache cache;
+    std::atomic<int> reads { 0 };
+    constexpr int workerCount = 8;
+    constexpr int pluginCount = 200;
+
+    std::vector<std::vector<std::string>> seen(workerCount * pluginCount);
+    {
+        std::vector<std::jthread> workers;
+        for (int w = 0; w < workerCount; ++w) {
+            workers.emplace_back([&, w] {
+                for (int p = 0; p < pluginCount; ++p) {
+                    const auto name   = "Plugin" + std::to_string(p) + ".esp";
+                    const auto header = cache.getOrRead(name, [&reads, &name] {
+                        ++reads;
+                        return PluginHeader { true, { "Skyrim.esm", name + ".master" } };
+                    });
+                    seen[w * pluginCount + p] = header.masters;
+                }
+            });
+        }
+    }
+
+    EXPECT_EQ(pluginCount, cache.size());
+    EXPECT_GE(reads.load(), pluginCount);
+    for (int w = 0; w < workerCount; ++w) {
+        for (int p = 0; p < pluginCount; ++p) {
+            ASSERT_EQ(seen[w * pluginCount + p], seen[p]);
+        }
+    }
+}
@@ -0,0 +1,173 @@
+#include "FOMODData/ModuleConfigCache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+
+class ModuleConfigCacheTest : public ::testing::Test {
+  protected:
+    std::filesystem::path cacheDir;
+    const std::string xml      = "<config><moduleName>Lux</moduleName></config>";
+    const std::string otherXml = "<config><moduleName>Lux (patch hub)</moduleName></config>";
+
+    void SetUp() override
+    {
+        cacheDir = std::filesystem::temp_directory_path()
+            / ("fomod_moduleconfig_cache_test_" + std::to_string(std::rand()));
+    }
+
+    void TearDown() override { std::filesystem::remove_all(cacheDir); }
+
+    static std::span<const char> bytes(const std::string& str) { return { str.data(), str.size() }; }
+
+    static ModuleConfiguration makeConfig()
+    {
+        ModuleConfiguration config;
+        config.moduleName           = "Lux";
+        config.moduleImage.path     = "fomod\\images\\header.png";
+        config.moduleImage.showFade = true;
+        config.moduleImage.height   = 120;
+
+        FileDependency skyrim;
+        skyrim.file  = "Skyrim.esm";
+        skyrim.state = FileDependencyTypeEnum::Active;
+        config.moduleDependencies.fileDependencies.push_back(skyrim);
+
+        File required;
+        required.source      = "core\\Lux.esp";
+        required.destination = "Lux.esp";
+        required.priority    = 2;
+        config.requiredInstallFiles.files.push_back(required);
+
+        Plugin plugin;
+        plugin.name        = "Patch";
+        plugin.description = "A patch";
+        plugin.conditionFlags.flags.push_back({});
+        plugin.conditionFlags.flags.back().name  = "patch";
+        plugin.conditionFlags.flags.back().value = "On";
+        plugin.typeDescriptor.type                       = PluginTypeEnum::Optional;
+        plugin.typeDescriptor.dependencyType.defaultType = PluginTypeEnum::NotUsable;
+        DependencyPattern pattern;
+        pattern.type                      = PluginTypeEnum::Recommended;
+        pattern.dependencies.operatorType = OperatorTypeEnum::OR;
+        pattern.dependencies.nestedDependencies.emplace_back().flagDependencies.push_back({});
+        pattern.dependencies.nestedDependencies.back().flagDependencies.back().flag  = "option";
+        pattern.dependencies.nestedDependencies.back().flagDependencies.back().value = "A";
+        plugin.typeDescriptor.dependencyType.patterns.patterns.push_back(pattern);
+        File folder;
+        folder.source   = "patches\\Patch";
+        folder.isFolder = true;
+        plugin.files.files.push_back(folder);
+
+        Group group;
+        group.name          = "Patches";
+        group.type          = SelectAtMostOne;
+        group.plugins.order = OrderTypeEnum::Explicit;
+        group.plugins.plugins.push_back(plugin);
+
+        InstallStep step;
+        step.name = "Step";
+        step.visible.gameDependencies.emplace_back().version = "1.6";
+        step.optionalFileGroups.order                        = OrderTypeEnum::Explicit;
+        step.optionalFileGroups.groups.push_back(group);
+        config.installSteps.order = OrderTypeEnum::Explicit;
+        config.installSteps.installSteps.push_back(step);
+
+        ConditionalFileInstallPattern conditional;
+        conditional.files.files.push_back(required);
+        config.conditionalFileInstalls.patterns.push_back(conditional);
+        return config;
+    }
+};
+
+TEST_F(ModuleConfigCacheTest, RoundTrip)
+{
+    const auto original = makeConfig();
+    ModuleConfigCache cache(cacheDir);
+    EXPECT_EQ(nullptr, cache.find(bytes(xml), ParseProfile::Full));
+    ASSERT_TRUE(cache.store(bytes(xml), ParseProfile::Full, original));
+
+    const auto cached = cache.find(bytes(xml), ParseProfile::Full);
+    ASSERT_NE(nullptr, cached);
+    EXPECT_EQ("Lux", cached->moduleName);
+    EXPECT_EQ(original.moduleImage.path, cached->moduleImage.path);
+    EXPECT_TRUE(cached->moduleImage.showFade);
+    EXPECT_EQ(120, cached->moduleImage.height);
+    ASSERT_EQ(1, cached->moduleDependencies.fileDependencies.size());
+    EXPECT_EQ(FileDependencyTypeEnum::Active, cached->moduleDependencies.fileDependencies[0].state);
+    ASSERT_EQ(1, cached->requiredInstallFiles.files.size());
+    EXPECT_EQ("Lux.esp", cached->requiredInstallFiles.files[0].destination);
+    EXPECT_EQ(2, cached->requiredInstallFiles.files[0].priority);
+
+    ASSERT_EQ(1, cached->installSteps.installSteps.size());
+    const auto& step = cached->installSteps.installSteps[0];
+    EXPECT_EQ("Step", step.name);
+    ASSERT_EQ(1, step.visible.gameDependencies.size());
+    EXPECT_EQ("1.6", step.visible.gameDependencies[0].version);
+    ASSERT_EQ(1, step.optionalFileGroups.groups.size());
+    const auto& group = step.optionalFileGroups.groups[0];
+    EXPECT_EQ(SelectAtMostOne, group.type);
+    EXPECT_EQ(OrderTypeEnum::Explicit, group.plugins.order);
+    ASSERT_EQ(1, group.plugins.plugins.size());
+
+    const auto& plugin = group.plugins.plugins[0];
+    EXPECT_EQ("A patch", plugin.description);
+    EXPECT_EQ("On", plugin.conditionFlags.flags.at(0).value);
+    EXPECT_EQ(PluginTypeEnum::NotUsable, plugin.typeDescriptor.dependencyType.defaultType);
+    const auto& pattern = plugin.typeDescriptor.dependencyType.patterns.patterns.at(0);
+    EXPECT_EQ(PluginTypeEnum::Recommended, pattern.type);
+    EXPECT_EQ(OperatorTypeEnum::OR, pattern.dependencies.operatorType);
+    EXPECT_EQ("A", pattern.dependencies.nestedDependencies.at(0).flagDependencies.at(0).value);
+    ASSERT_EQ(1, plugin.files.files.size());
+    EXPECT_TRUE(plugin.files.files[0].isFolder);
+    EXPECT_FALSE(plugin.files.files[0].destination.has_value());
+    EXPECT_EQ(1, cached->conditionalFileInstalls.patterns.size());
+}
+
+TEST_F(ModuleConfigCacheTest, KeyedByContentAndProfile)
+{
+    ModuleConfigCache cache(cacheDir);
+    ASSERT_TRUE(cache.store(bytes(xml), ParseProfile::IndexOnly, makeConfig()));
+
+    EXPECT_EQ(nullptr, cache.find(bytes(otherXml), ParseProfile::IndexOnly));
+    EXPECT_EQ(nullptr, cache.find(bytes(xml), ParseProfile::Full)); // An index can't stand in for the full model
+    EXPECT_NE(nullptr, cache.find(bytes(xml), ParseProfile::IndexOnly));
+
+    ASSERT_TRUE(cache.store(bytes(otherXml), ParseProfile::Full, makeConfig()));
+    EXPECT_NE(nullptr, cache.find(bytes(otherXml), ParseProfile::IndexOnly)); // But the full model can stand in for it
+}
+
+TEST_F(ModuleConfigCacheTest, CorruptEntryIsAMiss)
+{
+    ModuleConfigCache cache(cacheDir);
+    ASSERT_TRUE(cache.store(bytes(xml), ParseProfile::Full, makeConfig()));
+    for (const auto& file : std::filesystem::directory_iterator(cacheDir)) {
+        std::fstream entry(file.path(), std::ios::binary | std::ios::in | std::ios::out);
+        entry.seekp(-1, std::ios::end);
+        entry.put('\x7f');
+    }
+    EXPECT_EQ(nullptr, cache.find(bytes(xml), ParseProfile::Full));
+}
+
+TEST_F(ModuleConfigCacheTest, TrimEvictsLeastRecentlyUsed)
+{
+    const std::string third = "<config><moduleName>Third</moduleName></config>";
+    ModuleConfigCache cache(cacheDir, { .maxEntries = 2 });
+    const auto config = makeConfig();
+    cache.store(bytes(xml), ParseProfile::Full, config);
+    cache.store(bytes(otherXml), ParseProfile::Full, config);
+    cache.store(bytes(third), ParseProfile::Full, config);
+
+    // Age every entry, then use the last two so the first is the least recently used
+    const auto anHourAgo = std::filesystem::file_time_type::clock::now() - std::chrono::hours(1);
+    for (const auto& file : std::filesystem::directory_iterator(cacheDir)) {
+        std::filesystem::last_write_time(file.path(), anHourAgo);
+    }
+    ASSERT_NE(nullptr, cache.find(bytes(otherXml), ParseProfile::Full));
+    ASSERT_NE(nullptr, cache.find(bytes(third), ParseProfile::Full));
+
+    cache.trim();
+    EXPECT_EQ(nullptr, cache.find(bytes(xml), ParseProfile::Full));
+    EXPECT_NE(nullptr, cache.find(bytes(otherXml), ParseProfile::Full));
+    EXPECT_NE(nullptr, cache.find(bytes(third), ParseProfile::Full));
+}
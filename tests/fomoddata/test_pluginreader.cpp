@@ -48,4 +48,158 @@ TEST(PluginReaderTest, InvalidPlugin)
 
     // Reading masters from invalid file should return empty vector
     EXPECT_TRUE(PluginReader::readMasters("non_existent_file.esp").empty());
-}
\ No newline at end of file
+}
+TEST(PluginReaderTest, ReadMastersFromBuffer)
+{
+    const std::string testEspPath
+        = (std::filesystem::path(TEST_DATA_DIR) / "Lux - JK's The Hag's Cure patch.esp").string();
+
+    // Only the TES4 record is read, not the whole plugin
+    const auto header = PluginReader::readHeaderRecord(testEspPath);
+    ASSERT_GT(header.size(), PluginReader::RECORD_HEADER_SIZE);
+    EXPECT_LT(header.size(), std::filesystem::file_size(testEspPath));
+
+    const auto masters = PluginReader::readMastersFromBuffer(header);
+    EXPECT_EQ(masters, PluginReader::readMasters(testEspPath));
+    EXPECT_EQ(4, masters.size());
+
+    const std::vector<std::string> trimmed = { "JK's The Hag's Cure.esp", "Lux - Resources.esp", "Lux.esp" };
+    EXPECT_EQ(PluginReader::readMastersFromBuffer(header, true), trimmed);
+
+    // A truncated prefix yields the masters that fit, without reading past the end
+    const std::span<const char> prefix(header.data(), PluginReader::RECORD_HEADER_SIZE + 20);
+    EXPECT_LE(PluginReader::readMastersFromBuffer(prefix).size(), masters.size());
+    EXPECT_TRUE(PluginReader::readMastersFromBuffer(std::span<const char>(header.data(), 3)).empty());
+}
+
+namespace {
+template <typename T> void append(std::string& out, const T value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void appendSubrecord(std::string& out, const std::string_view type, const std::string_view data)
+{
+    out.append(type);
+    append<uint16_t>(out, static_cast<uint16_t>(data.size()));
+    out.append(data);
+}
+
+std::string makeRecord(const uint32_t flags, const std::string_view data)
+{
+    std::string record = "TES4";
+    append<uint32_t>(record, static_cast<uint32_t>(data.size()));
+    append<uint32_t>(record, flags);
+    record.append(PluginReader::RECORD_HEADER_SIZE - record.size(), '\0');
+    return record.append(data);
+}
+
+std::string makeFields()
+{
+    std::string fields;
+    std::string hedr;
+    append<float>(hedr, 1.7f);
+    append<uint32_t>(hedr, 5); // Record count
+    append<uint32_t>(hedr, 0x800);
+    appendSubrecord(fields, "HEDR", hedr);
+    appendSubrecord(fields, "CNAM", std::string_view("Lux\0", 4));
+    appendSubrecord(fields, "MAST", std::string_view("Skyrim.esm\0", 11));
+    appendSubrecord(fields, "DATA", std::string(8, '\0'));
+
+    // A master announced by an XXXX subrecord, as used for subrecords over 64 KB
+    const std::string_view lux("Lux.esp\0", 8);
+    fields.append("XXXX");
+    append<uint16_t>(fields, sizeof(uint32_t));
+    append<uint32_t>(fields, static_cast<uint32_t>(lux.size()));
+    fields.append("MAST");
+    append<uint16_t>(fields, 0);
+    fields.append(lux);
+    appendSubrecord(fields, "DATA", std::string(8, '\0'));
+
+    appendSubrecord(fields, "ONAM", std::string(3 * sizeof(uint32_t), '\0'));
+    std::string incc;
+    append<uint32_t>(incc, 42);
+    appendSubrecord(fields, "INCC", incc);
+    return fields;
+}
+} // namespace
+
+TEST(PluginReaderTest, ParseHeaderInPlace)
+{
+    const auto record = makeRecord(0, makeFields());
+    const auto header = PluginReader::parseHeader(record);
+
+    ASSERT_TRUE(header.valid);
+    ASSERT_EQ(2, header.masters.size());
+    EXPECT_EQ("Skyrim.esm", header.masters[0]);
+    EXPECT_EQ("Lux.esp", header.masters[1]);
+    EXPECT_EQ(3, header.overrideCount);
+    EXPECT_EQ(42, header.internalCellCount);
+    EXPECT_EQ(5, header.recordCount);
+    EXPECT_EQ(0, header.descriptionOffset);
+    const auto author = std::string_view(record).substr(PluginReader::RECORD_HEADER_SIZE + header.authorOffset, 3);
+    EXPECT_EQ("Lux", author);
+    EXPECT_TRUE(header.storage.empty());
+
+    // The masters are views into the record, not copies
+    EXPECT_GE(header.masters[0].data(), record.data());
+    EXPECT_LT(header.masters[0].data(), record.data() + record.size());
+
+    EXPECT_EQ(PluginReader::readMastersFromBuffer(record, true), std::vector<std::string> { "Lux.esp" });
+    EXPECT_FALSE(PluginReader::parseHeader(std::string_view("TES3")).valid);
+}
+
+TEST(PluginReaderTest, ParseCompressedHeader)
+{
+    const auto fields = makeFields();
+
+    // qCompress() output is a big-endian size and a zlib stream; plugins store a little-endian size instead
+    const auto zlib = qCompress(QByteArray(fields.data(), static_cast<qsizetype>(fields.size())));
+    std::string data;
+    append<uint32_t>(data, static_cast<uint32_t>(fields.size()));
+    data.append(zlib.data() + sizeof(uint32_t), static_cast<size_t>(zlib.size()) - sizeof(uint32_t));
+
+    const auto header = PluginReader::parseHeader(makeRecord(PluginReader::FLAG_COMPRESSED, data));
+    ASSERT_TRUE(header.valid);
+    EXPECT_FALSE(header.storage.empty());
+    ASSERT_EQ(2, header.masters.size());
+    EXPECT_EQ("Lux.esp", header.masters[1]);
+    EXPECT_EQ(3, header.overrideCount);
+    EXPECT_EQ(42, header.internalCellCount);
+}
+
+TEST(PluginReaderTest, ReadMastersBatch)
+{
+    const std::string testEspPath
+        = (std::filesystem::path(TEST_DATA_DIR) / "Lux - JK's The Hag's Cure patch.esp").string();
+    const auto expected = PluginReader::readMasters(testEspPath, true);
+
+    std::vector<std::string> paths(64, testEspPath);
+    paths[10] = "non_existent_file.esp";
+
+    const auto results = PluginReader::readMastersBatch(paths, true, 4);
+    ASSERT_EQ(paths.size(), results.size());
+    for (size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(i == 10 ? std::vector<std::string> {} : expected, results[i]) << "at " << i;
+    }
+}
+
+TEST(PluginReaderTest, ReadHeader)
+{
+    const std::string testEspPath
+        = (std::filesystem::path(TEST_DATA_DIR) / "Lux - JK's The Hag's Cure patch.esp").string();
+
+    const auto header = PluginReader::readHeader(testEspPath, true);
+    ASSERT_TRUE(header.valid);
+    EXPECT_EQ(header.masters, PluginReader::readMasters(testEspPath, true));
+    EXPECT_GT(header.recordCount, 0);
+    EXPECT_NE(0, header.checksum);
+
+    // One read of the TES4 record is enough for everything, including the checksum
+    const auto fromBuffer = PluginReader::readHeaderFromBuffer(PluginReader::readHeaderRecord(testEspPath), true);
+    EXPECT_EQ(header.masters, fromBuffer.masters);
+    EXPECT_EQ(header.flags, fromBuffer.flags);
+    EXPECT_EQ(header.checksum, fromBuffer.checksum);
+
+    EXPECT_FALSE(PluginReader::readHeader("non_existent_file.esp").valid);
+}
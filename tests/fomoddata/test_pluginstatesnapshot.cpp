@@ -0,0 +1,89 @@
+#include "FOMODData/ConditionEvaluator.h"
+#include "FOMODData/PluginStateSnapshot.h"
+
+#include <gtest/gtest.h>
+
+TEST(PluginStateSnapshotTest, LooksUpStatesCaseInsensitively)
+{
+    PluginStateSnapshot snapshot;
+    snapshot.set("Skyrim.esm", StoredFileState::Active);
+    snapshot.set("Lux.esp", StoredFileState::Inactive);
+
+    EXPECT_EQ(snapshot.state(StringId("Skyrim.esm")), StoredFileState::Active);
+    EXPECT_EQ(snapshot.state(StringId("skyrim.esm")), StoredFileState::Active);
+    EXPECT_EQ(snapshot.state(std::string_view("SKYRIM.ESM")), StoredFileState::Active);
+    EXPECT_EQ(snapshot(StringId("LUX.esp")), StoredFileState::Inactive);
+    EXPECT_EQ(snapshot.state(std::string_view("NotInLoadOrder.esp")), StoredFileState::Missing);
+}
+
+TEST(PluginStateSnapshotTest, LaterStateReplacesEarlier)
+{
+    PluginStateSnapshot snapshot;
+    snapshot.set("Lux.esp", StoredFileState::Inactive);
+    snapshot.set("lux.esp", StoredFileState::Active);
+
+    EXPECT_EQ(snapshot.state(StringId("lux.esp")), StoredFileState::Active);
+    EXPECT_EQ(snapshot.state(StringId("LUX.ESP")), StoredFileState::Active);
+
+    snapshot.clear();
+    EXPECT_EQ(snapshot.state(StringId("lux.esp")), StoredFileState::Missing);
+}
+
+TEST(PluginStateSnapshotTest, SettingAnotherCasingUpdatesEverySpelling)
+{
+    PluginStateSnapshot snapshot;
+    snapshot.set("Foo.ESP", StoredFileState::Inactive);
+    snapshot.set("foo.esp", StoredFileState::Active);
+
+    EXPECT_EQ(snapshot.state(StringId("Foo.ESP")), StoredFileState::Active);
+    EXPECT_EQ(snapshot.state(std::string_view("Foo.ESP")), StoredFileState::Active);
+    EXPECT_EQ(snapshot.state(StringId("foo.esp")), StoredFileState::Active);
+
+    snapshot.set("FOO.esp", StoredFileState::Missing);
+    EXPECT_EQ(snapshot.state(StringId("Foo.ESP")), StoredFileState::Missing);
+    EXPECT_EQ(snapshot.state(StringId("foo.esp")), StoredFileState::Missing);
+    EXPECT_EQ(1, snapshot.size());
+}
+
+TEST(PluginStateSnapshotTest, MatchesCachedResolver)
+{
+    // A synthetic load order and a DB whose options each test a handful of its plugins. benchmarkPluginStateSnapshot
+    // times the two resolvers over the same setup.
+    constexpr int pluginCount = 2000;
+    constexpr int optionCount = 5000;
+
+    std::unordered_map<std::string, StoredFileState> loadOrder;
+    PluginStateSnapshot snapshot;
+    for (int i = 0; i < pluginCount; ++i) {
+        const auto name  = "Plugin" + std::to_string(i) + ".esp";
+        const auto state = i % 3 == 0 ? StoredFileState::Inactive : StoredFileState::Active;
+        loadOrder[name]  = state;
+        snapshot.set(name, state);
+    }
+
+    std::vector<FomodOption> options;
+    options.reserve(optionCount);
+    for (int i = 0; i < optionCount; ++i) {
+        StoredTypePattern pattern;
+        pattern.type                      = StoredPluginType::Recommended;
+        pattern.dependencies.operatorType = i % 2 == 0 ? StoredOperator::And : StoredOperator::Or;
+        for (int d = 0; d < 4; ++d) {
+            // Every few options reference a plugin that isn't in the load order
+            const auto index = (i * 7 + d * 13) % (pluginCount + 100);
+            pattern.dependencies.fileDependencies.push_back(
+                { "Plugin" + std::to_string(index) + ".esp", StoredFileState::Active });
+        }
+        options.emplace_back("Option", "patch.esp", std::vector<StringId> {}, "Step", "Group",
+            SelectionState::Unknown, std::vector { pattern });
+    }
+
+    const auto cached = makeCachedResolver([&loadOrder](const std::string& fileName) {
+        const auto it = loadOrder.find(fileName);
+        return it != loadOrder.end() ? it->second : StoredFileState::Missing;
+    });
+
+    for (const auto& option : options) {
+        ASSERT_EQ(ConditionEvaluator::resolveMatchingType(option, cached),
+            ConditionEvaluator::resolveMatchingType(option, snapshot));
+    }
+}
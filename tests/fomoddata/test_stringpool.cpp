@@ -0,0 +1,50 @@
+#include "FOMODData/StringPool.h"
+
+#include <gtest/gtest.h>
+#include <unordered_set>
+
+TEST(StringPoolTest, EqualStringsShareOneHandle)
+{
+    const std::string owned = "Lux.esp";
+    const StringId a(owned);
+    const StringId b("Lux.esp");
+    const StringId c(std::string_view("Lux.esm"));
+
+    EXPECT_EQ(a, b);
+    EXPECT_EQ(&a.str(), &b.str());
+    EXPECT_FALSE(a == c);
+    EXPECT_EQ(a, "Lux.esp");
+    EXPECT_EQ(a, owned);
+}
+
+TEST(StringPoolTest, DefaultIsEmpty)
+{
+    const StringId empty;
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty, StringId(""));
+    EXPECT_EQ(empty, "");
+}
+
+TEST(StringPoolTest, FindDoesNotIntern)
+{
+    const auto before = StringPool::instance().size();
+    EXPECT_FALSE(StringId::find("Never Interned Anywhere.esp").has_value());
+    EXPECT_EQ(before, StringPool::instance().size());
+
+    const StringId skyrim("Skyrim.esm");
+    const auto found = StringId::find("Skyrim.esm");
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(*found, skyrim);
+}
+
+TEST(StringPoolTest, HashAndJson)
+{
+    const std::unordered_set<StringId> installed = { "Skyrim.esm", "Update.esm" };
+    EXPECT_TRUE(installed.contains(StringId("Update.esm")));
+    EXPECT_FALSE(installed.contains(StringId("Dawnguard.esm")));
+
+    const std::vector<StringId> masters = { "Skyrim.esm", "Lux.esp" };
+    const nlohmann::json json           = masters;
+    EXPECT_EQ(json, nlohmann::json({ "Skyrim.esm", "Lux.esp" }));
+    EXPECT_EQ(json.get<std::vector<StringId>>(), masters);
+}
@@ -0,0 +1,243 @@
+#include "ConditionGraph.h"
+
+#include <gtest/gtest.h>
+#include <random>
+
+namespace {
+const ConditionGraph::StaticTests ALWAYS_TRUE { [](const FileDependency&) { return true; },
+    [](const GameDependency&) { return true; } };
+
+// What the installer tested before the graph: the first flag set with the key, in getFlagsByKey order
+bool referenceTest(const FlagMap& flags, const CompositeDependency& dependency)
+{
+    std::vector<bool> results;
+    for (size_t i = 0; i < dependency.fileDependencies.size(); ++i) {
+        results.push_back(true);
+    }
+    for (const auto& flagDependency : dependency.flagDependencies) {
+        const auto set = flags.getFlagsByKey(flagDependency.flag);
+        results.push_back(set.empty() ? flagDependency.value.empty() : set.front().second == flagDependency.value);
+    }
+    for (const auto& nestedDependency : dependency.nestedDependencies) {
+        results.push_back(referenceTest(flags, nestedDependency));
+    }
+    if (dependency.operatorType == OperatorTypeEnum::AND) {
+        return std::ranges::all_of(results, [](const bool result) { return result; });
+    }
+    return std::ranges::any_of(results, [](const bool result) { return result; });
+}
+
+PluginTypeEnum referenceType(const FlagMap& flags, const Plugin& plugin)
+{
+    for (const auto& pattern : plugin.typeDescriptor.dependencyType.patterns.patterns) {
+        if (referenceTest(flags, pattern.dependencies)) {
+            return pattern.type;
+        }
+    }
+    if (plugin.typeDescriptor.type != PluginTypeEnum::Optional) {
+        return plugin.typeDescriptor.type;
+    }
+    return plugin.typeDescriptor.dependencyType.defaultType.value_or(PluginTypeEnum::Optional);
+}
+
+CompositeDependency flagIs(const std::string& flag, const std::string& value)
+{
+    CompositeDependency dependency;
+    dependency.flagDependencies.push_back({});
+    dependency.flagDependencies.back().flag  = flag;
+    dependency.flagDependencies.back().value = value;
+    return dependency;
+}
+
+void addPattern(Plugin& plugin, const CompositeDependency& dependencies, const PluginTypeEnum type)
+{
+    DependencyPattern pattern;
+    pattern.dependencies = dependencies;
+    pattern.type         = type;
+    plugin.typeDescriptor.dependencyType.patterns.patterns.push_back(pattern);
+}
+
+std::shared_ptr<PluginViewModel> pluginSetting(const std::string& flag, const std::string& value, const int step = 0)
+{
+    auto plugin = std::make_shared<Plugin>();
+    plugin->conditionFlags.flags.push_back({});
+    plugin->conditionFlags.flags.back().name  = flag;
+    plugin->conditionFlags.flags.back().value = value;
+    auto viewModel = std::make_shared<PluginViewModel>(plugin, true, true, 0);
+    viewModel->setStepIndex(step);
+    return viewModel;
+}
+
+class RandomConditions {
+  public:
+    explicit RandomConditions(const unsigned seed)
+        : rng(seed)
+    {
+    }
+
+    int below(const int n) { return std::uniform_int_distribution(0, n - 1)(rng); }
+
+    // Keys in mixed case, since FlagMap matches them case-insensitively
+    std::string key() { return KEYS[below(static_cast<int>(std::size(KEYS)))]; }
+
+    std::string value(const bool allowEmpty) { return VALUES[allowEmpty ? below(3) : 1 + below(2)]; }
+
+    CompositeDependency dependency(const int depth)
+    {
+        CompositeDependency dependency;
+        dependency.operatorType = below(2) ? OperatorTypeEnum::AND : OperatorTypeEnum::OR;
+        for (int i = below(4); i > 0; --i) {
+            dependency.flagDependencies.push_back({});
+            dependency.flagDependencies.back().flag  = key();
+            dependency.flagDependencies.back().value = value(true);
+        }
+        if (below(3) == 0) {
+            dependency.fileDependencies.emplace_back().file = "Lux.esp";
+        }
+        for (int i = depth < 3 ? below(3) : 0; i > 0; --i) {
+            dependency.nestedDependencies.push_back(this->dependency(depth + 1));
+        }
+        return dependency;
+    }
+
+  private:
+    static constexpr const char* KEYS[]   = { "A", "a", "B", "c", "C", "d" };
+    static constexpr const char* VALUES[] = { "", "On", "Off" };
+    std::mt19937 rng;
+};
+} // namespace
+
+TEST(ConditionGraphTest, MatchesFlagMapThroughTogglesAndRebuilds)
+{
+    RandomConditions random(42);
+
+    std::vector<std::shared_ptr<PluginViewModel>> plugins;
+    for (int i = 0; i < 12; ++i) {
+        auto plugin = std::make_shared<Plugin>();
+        for (int j = 1 + random.below(2); j > 0; --j) {
+            plugin->conditionFlags.flags.push_back({});
+            plugin->conditionFlags.flags.back().name  = random.key();
+            plugin->conditionFlags.flags.back().value = random.value(false);
+        }
+        auto viewModel = std::make_shared<PluginViewModel>(plugin, false, true, i % 3);
+        viewModel->setStepIndex(i / 3);
+        plugins.push_back(viewModel);
+    }
+
+    std::vector<CompositeDependency> conditions;
+    for (int i = 0; i < 200; ++i) {
+        conditions.push_back(random.dependency(0));
+    }
+    std::vector<Plugin> typedPlugins(50);
+    for (auto& plugin : typedPlugins) {
+        for (int i = random.below(3); i > 0; --i) {
+            addPattern(plugin, random.dependency(1), static_cast<PluginTypeEnum>(random.below(5)));
+        }
+        plugin.typeDescriptor.type = random.below(2) ? PluginTypeEnum::Optional : PluginTypeEnum::Required;
+        if (random.below(2)) {
+            plugin.typeDescriptor.dependencyType.defaultType = PluginTypeEnum::NotUsable;
+        }
+    }
+
+    FlagMap flags;
+    ConditionGraph graph;
+    for (int step = 0; step < 1000; ++step) {
+        if (random.below(10) == 0) {
+            // As the installer does after going back a step
+            flags.clearAll();
+            for (const auto& plugin : plugins) {
+                if (plugin->isSelected()) {
+                    flags.setFlagsForPlugin(plugin);
+                }
+            }
+        } else {
+            const auto& plugin = plugins[random.below(static_cast<int>(plugins.size()))];
+            plugin->setSelected(!plugin->isSelected());
+            if (plugin->isSelected()) {
+                flags.setFlagsForPlugin(plugin);
+            } else {
+                flags.unsetFlagsForPlugin(plugin);
+            }
+        }
+
+        for (int i = 0; i < 20; ++i) {
+            const auto& condition = conditions[random.below(static_cast<int>(conditions.size()))];
+            ASSERT_EQ(referenceTest(flags, condition), graph.test(graph.compile(condition, ALWAYS_TRUE), flags))
+                << "step " << step;
+        }
+        for (int i = 0; i < 5; ++i) {
+            const auto& plugin = typedPlugins[random.below(static_cast<int>(typedPlugins.size()))];
+            ASSERT_EQ(referenceType(flags, plugin), graph.pluginType(graph.compile(plugin, ALWAYS_TRUE), flags))
+                << "step " << step;
+        }
+    }
+}
+
+TEST(ConditionGraphTest, PluginTypeFallsBackToTypeThenDefaultType)
+{
+    FlagMap flags;
+    ConditionGraph graph;
+
+    Plugin untyped;
+    untyped.typeDescriptor.type = PluginTypeEnum::Optional; // As parsed from a descriptor without <type>
+    addPattern(untyped, flagIs("patch", "On"), PluginTypeEnum::Recommended);
+    EXPECT_EQ(PluginTypeEnum::Optional, graph.pluginType(graph.compile(untyped, ALWAYS_TRUE), flags));
+
+    Plugin withDefault                                    = untyped;
+    withDefault.typeDescriptor.dependencyType.defaultType = PluginTypeEnum::NotUsable;
+    EXPECT_EQ(PluginTypeEnum::NotUsable, graph.pluginType(graph.compile(withDefault, ALWAYS_TRUE), flags));
+
+    // A type next to the patterns takes precedence over their default
+    Plugin withType              = withDefault;
+    withType.typeDescriptor.type = PluginTypeEnum::Required;
+    EXPECT_EQ(PluginTypeEnum::Required, graph.pluginType(graph.compile(withType, ALWAYS_TRUE), flags));
+
+    flags.setFlagsForPlugin(pluginSetting("Patch", "On"));
+    EXPECT_EQ(PluginTypeEnum::Recommended, graph.pluginType(graph.compile(untyped, ALWAYS_TRUE), flags));
+    EXPECT_EQ(PluginTypeEnum::Recommended, graph.pluginType(graph.compile(withDefault, ALWAYS_TRUE), flags));
+    EXPECT_EQ(PluginTypeEnum::Recommended, graph.pluginType(graph.compile(withType, ALWAYS_TRUE), flags));
+}
+
+TEST(ConditionGraphTest, FirstHoldingPatternWins)
+{
+    Plugin plugin;
+    plugin.typeDescriptor.type = PluginTypeEnum::Optional;
+    addPattern(plugin, flagIs("race", "Khajiit"), PluginTypeEnum::NotUsable);
+    addPattern(plugin, flagIs("patch", "On"), PluginTypeEnum::Recommended);
+    addPattern(plugin, flagIs("race", ""), PluginTypeEnum::CouldBeUsable);
+
+    FlagMap flags;
+    ConditionGraph graph;
+    const auto id = graph.compile(plugin, ALWAYS_TRUE);
+    EXPECT_EQ(PluginTypeEnum::CouldBeUsable, graph.pluginType(id, flags));
+
+    const auto patch = pluginSetting("patch", "On");
+    flags.setFlagsForPlugin(patch);
+    EXPECT_EQ(PluginTypeEnum::Recommended, graph.pluginType(id, flags));
+
+    const auto khajiit = pluginSetting("Race", "Khajiit");
+    flags.setFlagsForPlugin(khajiit);
+    EXPECT_EQ(PluginTypeEnum::NotUsable, graph.pluginType(id, flags));
+
+    // A later step overrides the value the pattern tests
+    const auto argonian = pluginSetting("race", "Argonian", 1);
+    flags.setFlagsForPlugin(argonian);
+    EXPECT_EQ(PluginTypeEnum::Recommended, graph.pluginType(id, flags));
+
+    flags.unsetFlagsForPlugin(patch);
+    EXPECT_EQ(PluginTypeEnum::Optional, graph.pluginType(id, flags));
+
+    flags.unsetFlagsForPlugin(argonian);
+    EXPECT_EQ(PluginTypeEnum::NotUsable, graph.pluginType(id, flags));
+}
+
+TEST(ConditionGraphTest, SharesIdenticalConditions)
+{
+    ConditionGraph graph;
+    const auto first  = flagIs("patch", "On");
+    const auto second = flagIs("PATCH", "On");
+    const auto nodes  = graph.size();
+    EXPECT_EQ(graph.compile(first, ALWAYS_TRUE), graph.compile(second, ALWAYS_TRUE));
+    EXPECT_EQ(nodes + 2, graph.size()); // The flag test and the AND around it
+    EXPECT_NE(graph.compile(first, ALWAYS_TRUE), graph.compile(flagIs("patch", "Off"), ALWAYS_TRUE));
+}
@@ -1,6 +1,7 @@
 ﻿#include "xml/ModuleConfiguration.h"
 #include <QString>
 #include <filesystem>
+#include <fstream>
 #include <gtest/gtest.h>
 #include <pugixml.hpp>
 
@@ -119,4 +120,52 @@ TEST_F(ModuleConfigurationTest_Lux, NotFolders)
     const auto firstPlugin = moduleConfig.installSteps.installSteps[0].optionalFileGroups.groups[0].plugins.plugins[0];
     EXPECT_EQ(firstPlugin.name, "Fort Windpoint");
     EXPECT_EQ(firstPlugin.files.files[0].isFolder, false);
-}
\ No newline at end of file
+}
+
+TEST_F(ModuleConfigurationTest_Lux, DeserializeFromBuffer)
+{
+    const auto filePath = std::filesystem::path(__FILE__).parent_path() / "test_moduleconf_lux.xml";
+    std::ifstream file(filePath, std::ios::binary);
+    const std::vector<char> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    ASSERT_FALSE(buffer.empty());
+
+    ModuleConfiguration fromBuffer;
+    ASSERT_TRUE(fromBuffer.deserialize(std::span<const char>(buffer)));
+    EXPECT_EQ(fromBuffer.moduleName, moduleConfig.moduleName);
+    ASSERT_EQ(fromBuffer.installSteps.installSteps.size(), moduleConfig.installSteps.installSteps.size());
+    EXPECT_EQ(fromBuffer.installSteps.installSteps[0].optionalFileGroups.groups.size(),
+        moduleConfig.installSteps.installSteps[0].optionalFileGroups.groups.size());
+}
+
+TEST_F(ModuleConfigurationTest_Lux, DeserializeIndexOnly)
+{
+    const auto filePath = std::filesystem::path(__FILE__).parent_path() / "test_moduleconf_lux.xml";
+    ModuleConfiguration index;
+    ASSERT_TRUE(index.deserialize(QString::fromStdString(filePath.string()), ParseProfile::IndexOnly));
+
+    EXPECT_EQ(index.moduleName, moduleConfig.moduleName);
+    EXPECT_TRUE(index.moduleImage.path.empty());
+    ASSERT_EQ(index.installSteps.installSteps.size(), moduleConfig.installSteps.installSteps.size());
+    for (size_t s = 0; s < index.installSteps.installSteps.size(); ++s) {
+        const auto& step     = index.installSteps.installSteps[s];
+        const auto& fullStep = moduleConfig.installSteps.installSteps[s];
+        EXPECT_EQ(step.name, fullStep.name);
+        ASSERT_EQ(step.optionalFileGroups.groups.size(), fullStep.optionalFileGroups.groups.size());
+        for (size_t g = 0; g < step.optionalFileGroups.groups.size(); ++g) {
+            const auto& plugins     = step.optionalFileGroups.groups[g].plugins.plugins;
+            const auto& fullPlugins = fullStep.optionalFileGroups.groups[g].plugins.plugins;
+            ASSERT_EQ(plugins.size(), fullPlugins.size());
+            for (size_t p = 0; p < plugins.size(); ++p) {
+                EXPECT_EQ(plugins[p].name, fullPlugins[p].name);
+                EXPECT_EQ(plugins[p].typeDescriptor.dependencyType.patterns.patterns.size(),
+                    fullPlugins[p].typeDescriptor.dependencyType.patterns.patterns.size());
+                ASSERT_EQ(plugins[p].files.files.size(), fullPlugins[p].files.files.size());
+                for (size_t f = 0; f < plugins[p].files.files.size(); ++f) {
+                    EXPECT_EQ(plugins[p].files.files[f].source, fullPlugins[p].files.files[f].source);
+                    EXPECT_FALSE(plugins[p].files.files[f].destination.has_value());
+                }
+                EXPECT_TRUE(plugins[p].description.empty());
+            }
+        }
+    }
+}
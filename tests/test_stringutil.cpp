@@ -8,6 +8,23 @@ TEST(StringUtil, Trim_Copy)
     EXPECT_EQ(trim(str), "extra spaces");
 }
 
+TEST(StringUtilTests, EndsWithPathCaseInsensitive)
+{
+    const std::wstring_view moduleConfig = StringConstants::FomodFiles::W_MODULE_CONFIG;
+    EXPECT_TRUE(endsWithPathCaseInsensitive(L"Lux/fomod/ModuleConfig.xml", moduleConfig));
+    EXPECT_TRUE(endsWithPathCaseInsensitive(L"Lux\\FOMOD\\moduleconfig.XML", moduleConfig));
+    EXPECT_TRUE(endsWithPathCaseInsensitive(L"fomod\\ModuleConfig.xml", moduleConfig));
+    EXPECT_FALSE(endsWithPathCaseInsensitive(L"fomod/info.xml", moduleConfig));
+    EXPECT_FALSE(endsWithPathCaseInsensitive(L"ModuleConfig.xml", moduleConfig));
+    EXPECT_FALSE(endsWithPathCaseInsensitive(L"", moduleConfig));
+
+    EXPECT_TRUE(endsWithCaseInsensitive(L"Textures\\Lux.DDS", L".dds"));
+    EXPECT_FALSE(endsWithCaseInsensitive(L"Textures/Lux.dds", L"\\lux.dds"));
+
+    EXPECT_TRUE(isPluginFile(std::wstring_view(L"Patches\\Lux - Patch.ESP")));
+    EXPECT_FALSE(isPluginFile(std::wstring_view(L"Textures\\Lux.dds")));
+}
+
 TEST(StringUtilTests, FormatPluginDescription_UrlConversion)
 {
     QString input    = "Check this link: https://example.com";